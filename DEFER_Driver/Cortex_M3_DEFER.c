@@ -0,0 +1,269 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_DEFER.c
+ * @author         : Ahmed Khaled
+ * @brief          : Deferred Work Source File
+ ******************************************************************************/
+
+
+#include "DEFER/Cortex_M3_DEFER.h"
+#include "SCB/Cortex_M3_SCB.h"
+#include "Libraries/CORE_INTRINSICS.h"
+
+
+#define DEFER_QUEUE_MASK		(DEFER_QUEUE_SIZE - 1U)
+
+typedef char DEFER_QUEUE_SIZE_CHECK[((DEFER_QUEUE_SIZE & DEFER_QUEUE_MASK) == 0U) ? 1 : -1];	/*Power of two*/
+
+
+/* Software interrupt and priority of each level */
+static const IRQn_Type DEFER_LevelIRQn[DEFER_LEVELS]     = {DEFER_LEVEL0_IRQn, DEFER_LEVEL1_IRQn};
+static const u32       DEFER_LevelPriority[DEFER_LEVELS] = {DEFER_LEVEL0_PRIORITY, DEFER_LEVEL1_PRIORITY};
+
+/* 1 once DEFER_Init installed the handler and enabled the interrupt of the level */
+static u8 DEFER_u8LevelReady[DEFER_LEVELS];
+
+/* Queues attached to each level */
+static DEFER_Queue_Type * DEFER_LevelQueues[DEFER_LEVELS][DEFER_MAX_QUEUES_PER_LEVEL];
+
+
+static void DEFER_Level0Handler(void)
+{
+	(void)DEFER_Drain(0);
+}
+
+static void DEFER_Level1Handler(void)
+{
+	(void)DEFER_Drain(1);
+}
+
+static const SCB_Handler_Type DEFER_LevelHandler[DEFER_LEVELS] = {DEFER_Level0Handler, DEFER_Level1Handler};
+
+
+/**
+ *  brief 	 	Ring Push
+ *  details		Adds an item to a ring (producer side only). Does not raise any interrupt.
+ *  param [in]	Queue  Ring
+ *  param [in]	Work   Item to add
+ * 	return		OK     Item added
+ * 	return		ERROR  Ring full (the item is counted in Queue->Dropped)
+ */
+
+States_Type DEFER_RingPush(DEFER_Queue_Type * Queue, const DEFER_Work_Type * Work)
+{
+	u32 Head = Queue->Head;
+
+	if((Head - Queue->Tail) >= DEFER_QUEUE_SIZE)
+	{
+		Queue->Dropped++;
+		return ERROR;
+	}
+
+	Queue->Items[Head & DEFER_QUEUE_MASK] = *Work;
+
+	/* The item must be visible before the consumer sees the new head */
+	CORE_DMB();
+	Queue->Head = Head + 1U;
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Ring Pop
+ *  details		Removes the oldest item of a ring (consumer side only).
+ *  param [in]	Queue  Ring
+ *  param [out]	Work   Receives the item
+ * 	return		OK     An item was removed
+ * 	return		ERROR  Ring empty
+ */
+
+States_Type DEFER_RingPop(DEFER_Queue_Type * Queue, DEFER_Work_Type * Work)
+{
+	u32 Tail = Queue->Tail;
+
+	if(Tail == Queue->Head)
+	{
+		return ERROR;
+	}
+
+	/* Read the item only after the head that published it */
+	CORE_DMB();
+	*Work = Queue->Items[Tail & DEFER_QUEUE_MASK];
+
+	/* The slot is free for the producer once the item was copied */
+	CORE_DMB();
+	Queue->Tail = Tail + 1U;
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Init
+ *  details		Installs the level handlers in the SRAM vector table, sets the priority of the
+ *  			level interrupts and enables them.
+ * 	return		OK     Every level is ready
+ * 	return		ERROR  The vector table is not in SRAM: the level interrupts stay disabled
+ */
+
+States_Type DEFER_Init(void)
+{
+	States_Type State = OK;
+	u8 Level;
+
+	for(Level = 0; Level < DEFER_LEVELS; Level++)
+	{
+		DEFER_u8LevelReady[Level] = 0;
+		NVIC_DisableIRQ(DEFER_LevelIRQn[Level]);
+
+		/* Never enable a level whose vector may be undefined (TIM6/TIM7 on medium density parts) */
+		if(SCB_SetVector(DEFER_LevelIRQn[Level], DEFER_LevelHandler[Level]) != OK)
+		{
+			State = ERROR;
+			continue;
+		}
+		NVIC_SetPriority(DEFER_LevelIRQn[Level], DEFER_LevelPriority[Level]);
+		NVIC_ClearPendingIRQ(DEFER_LevelIRQn[Level]);
+		NVIC_EnableIRQ(DEFER_LevelIRQn[Level]);
+		DEFER_u8LevelReady[Level] = 1;
+	}
+	return State;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Register Queue
+ *  details		Attaches a queue to a deferred work level. Use one queue per producer.
+ *  param [in]	Queue  Queue to attach (emptied)
+ *  param [in]	Level  0 .. DEFER_LEVELS-1
+ * 	return		OK     Queue attached
+ * 	return		ERROR  Invalid level, queue already registered or no free slot in the level
+ *  			(the queue is then left untouched)
+ */
+
+States_Type DEFER_RegisterQueue(DEFER_Queue_Type * Queue, u8 Level)
+{
+	u8 Slot;
+	u8 Free = DEFER_MAX_QUEUES_PER_LEVEL;
+	u8 Other;
+
+	if((Queue == NULL) || (Level >= DEFER_LEVELS))
+	{
+		return ERROR;
+	}
+
+	/* A registered queue may be drained right now: reject it before touching it */
+	for(Other = 0; Other < DEFER_LEVELS; Other++)
+	{
+		for(Slot = 0; Slot < DEFER_MAX_QUEUES_PER_LEVEL; Slot++)
+		{
+			if(DEFER_LevelQueues[Other][Slot] == Queue)
+			{
+				return ERROR;
+			}
+			if((Other == Level) && (Free == DEFER_MAX_QUEUES_PER_LEVEL) && (DEFER_LevelQueues[Other][Slot] == NULL))
+			{
+				Free = Slot;
+			}
+		}
+	}
+	if(Free == DEFER_MAX_QUEUES_PER_LEVEL)
+	{
+		return ERROR;
+	}
+
+	/* Empty the queue before the handler can see it */
+	Queue->Head    = 0;
+	Queue->Tail    = 0;
+	Queue->Dropped = 0;
+	Queue->Level   = Level;
+	CORE_DMB();
+	DEFER_LevelQueues[Level][Free] = Queue;
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Post
+ *  details		Queues a work item and pends the software interrupt of the queue level.
+ *  param [in]	Queue     Queue of the caller
+ *  param [in]	Function  Work to run
+ *  param [in]	Arg       Argument passed to Function
+ * 	return		OK     Work queued
+ * 	return		ERROR  Queue full, invalid arguments or level not initialised
+ */
+
+States_Type DEFER_Post(DEFER_Queue_Type * Queue, DEFER_Function_Type Function, void * Arg)
+{
+	DEFER_Work_Type Work;
+
+	if((Queue == NULL) || (Function == NULL) || (Queue->Level >= DEFER_LEVELS) ||
+	   (DEFER_u8LevelReady[Queue->Level] == 0))
+	{
+		return ERROR;
+	}
+
+	Work.Function = Function;
+	Work.Arg      = Arg;
+	if(DEFER_RingPush(Queue, &Work) != OK)
+	{
+		return ERROR;
+	}
+
+	/* Single store to NVIC_STIR, the drain runs once no higher priority is active */
+	DEFER_TRIGGER(DEFER_LevelIRQn[Queue->Level]);
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Drain
+ *  details		Runs every queued item of a level until all its queues are empty.
+ *  param [in]	Level  0 .. DEFER_LEVELS-1
+ * 	return		Number of items run
+ */
+
+u32 DEFER_Drain(u8 Level)
+{
+	DEFER_Work_Type Work;
+	u32 Count = 0;
+	u8  Slot;
+	u8  Pending;
+
+	if(Level >= DEFER_LEVELS)
+	{
+		return 0;
+	}
+
+	/* One item per queue per round, so a busy producer can not starve the others */
+	do
+	{
+		Pending = 0;
+		for(Slot = 0; Slot < DEFER_MAX_QUEUES_PER_LEVEL; Slot++)
+		{
+			if((DEFER_LevelQueues[Level][Slot] != NULL) &&
+			   (DEFER_RingPop(DEFER_LevelQueues[Level][Slot], &Work) == OK))
+			{
+				Work.Function(Work.Arg);
+				Count++;
+				Pending = 1;
+			}
+		}
+	}while(Pending == 1);
+
+	return Count;
+}
@@ -0,0 +1,148 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_DEFER.h
+ * @author         : Ahmed Khaled
+ * @brief          : Deferred Work Header File
+ ******************************************************************************/
+
+#ifndef CORTEX_M3_DEFER_H_
+#define CORTEX_M3_DEFER_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+#include "NVIC/Cortex_M3_NVIC.h"
+/***************************************End Include Section*****************/
+
+/********************************************Config Section Start********************************/
+
+/*
+ * ISRs post small work items to a queue and return. Each priority level of deferred
+ * work owns a software interrupt (an IRQ line unused by the application) that drains
+ * the queues of that level at its own, lower priority.
+ */
+#define DEFER_LEVELS						2U					/*Number of deferred work priority levels*/
+#define DEFER_QUEUE_SIZE					16U					/*Items per queue, must be a power of two*/
+#define DEFER_MAX_QUEUES_PER_LEVEL			4U					/*Queues (producers) per level*/
+
+#ifndef DEFER_LEVEL0_IRQn
+#define DEFER_LEVEL0_IRQn					TIM6_IRQn			/*Software interrupt of level 0 (not wired on STM32F103C8)*/
+#endif
+#ifndef DEFER_LEVEL0_PRIORITY
+#define DEFER_LEVEL0_PRIORITY				14U					/*NVIC_SetPriority value of level 0*/
+#endif
+#ifndef DEFER_LEVEL1_IRQn
+#define DEFER_LEVEL1_IRQn					TIM7_IRQn			/*Software interrupt of level 1 (not wired on STM32F103C8)*/
+#endif
+#ifndef DEFER_LEVEL1_PRIORITY
+#define DEFER_LEVEL1_PRIORITY				15U					/*NVIC_SetPriority value of level 1*/
+#endif
+
+/* How a level interrupt is raised; a host build can redefine it to call the drain directly */
+#ifndef DEFER_TRIGGER
+#define DEFER_TRIGGER(IRQn)					NVIC_TriggerIRQ(IRQn)
+#endif
+
+/********************************************Config Section End**********************************/
+
+/******************************Start Data Type Section***********************/
+
+typedef void (*DEFER_Function_Type)(void * Arg);
+
+typedef struct {
+	DEFER_Function_Type Function;		// Work to run at the deferred level
+	void * Arg;							// Argument passed to Function
+} DEFER_Work_Type;
+
+/*
+ * Lock-free single-producer / single-consumer ring.
+ * Head is only written by the producer (one ISR or one priority level),
+ * Tail only by the drain of its level. Both are free running counters.
+ */
+typedef struct {
+	DEFER_Work_Type Items[DEFER_QUEUE_SIZE];
+	volatile u32 Head;
+	volatile u32 Tail;
+	u32 Dropped;						// Items rejected because the ring was full
+	u8  Level;
+} DEFER_Queue_Type;
+
+/******************************End Data Type Section***********************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Ring Push
+ *  details		Adds an item to a ring (producer side only). Does not raise any interrupt.
+ *  param [in]	Queue  Ring
+ *  param [in]	Work   Item to add
+ * 	return		OK     Item added
+ * 	return		ERROR  Ring full (the item is counted in Queue->Dropped)
+ */
+
+States_Type DEFER_RingPush(DEFER_Queue_Type * Queue, const DEFER_Work_Type * Work);
+
+/**
+ *  brief 	 	Ring Pop
+ *  details		Removes the oldest item of a ring (consumer side only).
+ *  param [in]	Queue  Ring
+ *  param [out]	Work   Receives the item
+ * 	return		OK     An item was removed
+ * 	return		ERROR  Ring empty
+ */
+
+States_Type DEFER_RingPop(DEFER_Queue_Type * Queue, DEFER_Work_Type * Work);
+
+/**
+ *  brief 	 	Init
+ *  details		Installs the level handlers in the vector table, sets the priority of the level
+ *  			interrupts and enables them. The vector table must have been relocated with
+ *  			SCB_RelocateVectorTable: the default level IRQs (TIM6/TIM7) have no vector on the
+ *  			medium density STM32F103C8.
+ * 	return		OK     Every level is ready
+ * 	return		ERROR  A handler could not be installed, its level interrupt stays disabled and
+ * 				DEFER_Post to that level fails
+ */
+
+States_Type DEFER_Init(void);
+
+/**
+ *  brief 	 	Register Queue
+ *  details		Attaches a queue to a deferred work level. Use one queue per producer.
+ *  param [in]	Queue  Queue to attach (emptied)
+ *  param [in]	Level  0 .. DEFER_LEVELS-1
+ * 	return		OK     Queue attached
+ * 	return		ERROR  Invalid level, queue already registered or no free slot in the level
+ *  			(the queue is then left untouched)
+ */
+
+States_Type DEFER_RegisterQueue(DEFER_Queue_Type * Queue, u8 Level);
+
+/**
+ *  brief 	 	Post
+ *  details		Queues a work item and pends the software interrupt of the queue level.
+ *  			Meant to be called from the ISR that owns the queue.
+ *  param [in]	Queue     Queue of the caller
+ *  param [in]	Function  Work to run
+ *  param [in]	Arg       Argument passed to Function
+ * 	return		OK     Work queued
+ * 	return		ERROR  Queue full, invalid arguments or level not initialised (DEFER_Init)
+ */
+
+States_Type DEFER_Post(DEFER_Queue_Type * Queue, DEFER_Function_Type Function, void * Arg);
+
+/**
+ *  brief 	 	Drain
+ *  details		Runs every queued item of a level, oldest first in each queue, until all its
+ *  			queues are empty. Called by the level interrupt handler.
+ *  param [in]	Level  0 .. DEFER_LEVELS-1
+ * 	return		Number of items run
+ */
+
+u32 DEFER_Drain(u8 Level);
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* CORTEX_M3_DEFER_H_ */
@@ -0,0 +1,41 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_DWT.c
+ * @author         : Ahmed Khaled
+ * @brief          : DWT Source File
+ ******************************************************************************/
+
+
+#include "DWT/Cortex_M3_DWT.h"
+#include "Libraries/BIT_MATH.h"
+
+
+/**
+ *  brief 	 	Enable Cycle Counter
+ *  details		Powers the DWT unit (DEMCR TRCENA) and starts the free running cycle counter.
+ *  note		Calling it again while the counter runs has no effect on the count.
+ */
+
+void DWT_EnableCycleCounter(void)
+{
+	/* The DWT registers are only accessible once trace is enabled */
+	SET_BIT(DEMCR, DEMCR_TRCENA_POS);
+
+	/* Start the counter (it keeps its value if it was already running) */
+	SET_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_POS);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Cycle Count
+ *  details		Returns the current value of the DWT cycle counter (core clock cycles).
+ * 	return		DWT->CYCCNT
+ */
+
+u32 DWT_GetCycleCount(void)
+{
+	return DWT_GET_CYCLES();
+}
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_DWT.h
+ * @author         : Ahmed Khaled
+ * @brief          : DWT Header File
+ ******************************************************************************/
+
+#ifndef CORTEX_M3_DWT_H_
+#define CORTEX_M3_DWT_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+/***************************************End Include Section*****************/
+/******************************Start Data Type Section***********************/
+
+typedef struct {
+	volatile u32 CTRL;                 // Control Register
+	volatile u32 CYCCNT;               // Cycle Count Register
+	volatile u32 CPICNT;               // CPI Count Register
+	volatile u32 EXCCNT;               // Exception Overhead Count Register
+	volatile u32 SLEEPCNT;             // Sleep Count Register
+	volatile u32 LSUCNT;               // LSU Count Register
+	volatile u32 FOLDCNT;              // Folded-instruction Count Register
+	volatile u32 PCSR;                 // Program Counter Sample Register
+} DWT_Type;
+
+
+/******************************End Data Type Section***********************/
+
+/********************************************Macro Section Start********************************/
+#define DWT_BASE        (0xE0001000U)       // DWT base address
+#define DWT             ((DWT_Type *) DWT_BASE)
+
+#define DEMCR           (*((volatile u32 *) 0xE000EDFCU))	// Debug Exception and Monitor Control Register
+
+#define DEMCR_TRCENA_POS					24U					/*DEMCR  Trace enable Position (powers the DWT)*/
+#define DWT_CTRL_CYCCNTENA_POS				0U					/*DWT_CTRL  Cycle counter enable Position*/
+
+/*
+ * Read the cycle counter without a function call (for hot paths).
+ * The counter wraps every 2^32 cycles, so differences must be computed in u32.
+ */
+#define DWT_GET_CYCLES()					(DWT->CYCCNT)
+
+/********************************************Macro End Section**********************************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Enable Cycle Counter
+ *  details		Powers the DWT unit (DEMCR TRCENA) and starts the free running cycle counter.
+ *  note		Calling it again while the counter runs has no effect on the count.
+ */
+void DWT_EnableCycleCounter(void);
+
+/**
+ *  brief 	 	Get Cycle Count
+ *  details		Returns the current value of the DWT cycle counter (core clock cycles).
+ * 	return		DWT->CYCCNT
+ */
+u32 DWT_GetCycleCount(void);
+
+
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* CORTEX_M3_DWT_H_ */
@@ -0,0 +1,162 @@
+/**
+ ******************************************************************************
+ * @file           : DEFER_Bench.c
+ * @author         : Ahmed Khaled
+ * @brief          : Deferred Work Throughput Benchmark
+ ******************************************************************************
+ *
+ * Measures the DEFER driver on the host: ring push + pop, DEFER_Post + level
+ * drain in bursts (the STIR write lands in the NVIC_Sim register model), and
+ * the item rate of one producer thread feeding one consumer thread.
+ * Host numbers compare revisions of the driver, they are not target cycles.
+ *
+ * Build (include paths as for the target: NVIC/, SCB/, DEFER/, Libraries/):
+ *   gcc -std=c99 -O2 -DCORE_SIMULATION -I<include root> -I../NVIC_Sim DEFER_Bench.c \
+ *       ../NVIC_Sim/NVIC_Sim.c Cortex_M3_DEFER.c Cortex_M3_NVIC.c Cortex_M3_SCB.c \
+ *       -pthread -o defer_bench
+ *
+ * Usage: defer_bench [items]       (default 10000000)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "NVIC_Sim.h"
+#include "DEFER/Cortex_M3_DEFER.h"
+
+
+#define BENCH_DEFAULT_ITEMS		10000000UL
+#define BENCH_BURST				(DEFER_QUEUE_SIZE / 2U)
+
+
+static u32 BENCH_u32FlashVectors[SCB_VECTOR_TABLE_SIZE];
+static volatile unsigned long BENCH_ulSink;
+static unsigned long BENCH_ulItems;
+
+static DEFER_Queue_Type BENCH_Ring;
+static DEFER_Queue_Type BENCH_Queue;
+
+
+static double BENCH_Now(void)
+{
+	struct timespec Time;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (double)Time.tv_sec + (double)Time.tv_nsec * 1e-9;
+}
+
+
+static void BENCH_Work(void * Arg)
+{
+	BENCH_ulSink += (unsigned long)Arg;
+}
+
+
+static void * BENCH_Producer(void * Arg)
+{
+	DEFER_Work_Type Work;
+	unsigned long Item;
+
+	(void)Arg;
+	Work.Function = BENCH_Work;
+	for(Item = 0; Item < BENCH_ulItems; Item++)
+	{
+		Work.Arg = (void *)Item;
+		while(DEFER_RingPush(&BENCH_Ring, &Work) != OK)
+		{
+			(void)sched_yield();
+		}
+	}
+	return NULL;
+}
+
+
+int main(int argc, char * argv[])
+{
+	DEFER_Work_Type Work;
+	SCB_Handler_Type Level0;
+	pthread_t Producer;
+	unsigned long Item;
+	unsigned long Done;
+	u32 Index;
+	double Start;
+	double Time;
+
+	BENCH_ulItems = (argc > 1) ? strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_ITEMS;
+	if(BENCH_ulItems == 0)
+	{
+		fprintf(stderr, "usage: %s [items]\n", argv[0]);
+		return 2;
+	}
+
+	NVICSIM_Reset();
+	SCB_SimRegisters.VTOR = (u32)BENCH_u32FlashVectors;
+	SCB_RelocateVectorTable();
+	if((DEFER_Init() != OK) || (DEFER_RegisterQueue(&BENCH_Queue, 0) != OK))
+	{
+		fprintf(stderr, "DEFER_Init failed\n");
+		return 1;
+	}
+	Level0 = SCB_GetVector(DEFER_LEVEL0_IRQn);
+
+	/* Push + pop of one item, same thread */
+	Work.Function = BENCH_Work;
+	Work.Arg = NULL;
+	Start = BENCH_Now();
+	for(Item = 0; Item < BENCH_ulItems; Item++)
+	{
+		(void)DEFER_RingPush(&BENCH_Ring, &Work);
+		(void)DEFER_RingPop(&BENCH_Ring, &Work);
+	}
+	Time = BENCH_Now() - Start;
+	printf("ring push+pop          %8.2f ns/item\n", Time * 1e9 / (double)BENCH_ulItems);
+
+	/* Post in bursts, then one level interrupt drains and runs them */
+	Done = 0;
+	Start = BENCH_Now();
+	while(Done < BENCH_ulItems)
+	{
+		for(Index = 0; Index < BENCH_BURST; Index++)
+		{
+			(void)DEFER_Post(&BENCH_Queue, BENCH_Work, (void *)1UL);
+		}
+		Level0();
+		Done += BENCH_BURST;
+	}
+	Time = BENCH_Now() - Start;
+	printf("post+drain, %2lu/burst  %8.2f ns/item\n", (unsigned long)BENCH_BURST,
+		   Time * 1e9 / (double)Done);
+
+	/* One producer thread, this thread consumes */
+	BENCH_Ring.Head = 0;
+	BENCH_Ring.Tail = 0;
+	Done = 0;
+	Start = BENCH_Now();
+	if(pthread_create(&Producer, NULL, BENCH_Producer, NULL) != 0)
+	{
+		fprintf(stderr, "pthread_create failed\n");
+		return 1;
+	}
+	while(Done < BENCH_ulItems)
+	{
+		if(DEFER_RingPop(&BENCH_Ring, &Work) == OK)
+		{
+			Work.Function(Work.Arg);
+			Done++;
+		}
+		else
+		{
+			(void)sched_yield();
+		}
+	}
+	(void)pthread_join(Producer, NULL);
+	Time = BENCH_Now() - Start;
+	printf("producer->consumer     %8.2f Mitems/s\n", (double)Done / Time * 1e-6);
+
+	return 0;
+}
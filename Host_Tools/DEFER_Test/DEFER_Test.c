@@ -0,0 +1,237 @@
+/**
+ ******************************************************************************
+ * @file           : DEFER_Test.c
+ * @author         : Ahmed Khaled
+ * @brief          : Deferred Work Host Test
+ ******************************************************************************
+ *
+ * Runs the real DEFER driver on Linux against the register model of
+ * Host_Tools/NVIC_Sim: ring order / overflow / counter wrap-around, a
+ * producer / consumer thread pair on one ring, DEFER_Init with and without a
+ * relocated vector table, and DEFER_Post / level handler round robin.
+ *
+ * Build (include paths as for the target: NVIC/, SCB/, DEFER/, Libraries/):
+ *   gcc -std=c99 -O2 -DCORE_SIMULATION -I<include root> -I.. -I../NVIC_Sim DEFER_Test.c \
+ *       ../NVIC_Sim/NVIC_Sim.c Cortex_M3_DEFER.c Cortex_M3_NVIC.c Cortex_M3_SCB.c \
+ *       -pthread -o defer_test
+ *
+ * Exit status: 0 every check passed, 1 otherwise.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "NVIC_Sim.h"
+#include "DEFER/Cortex_M3_DEFER.h"
+#include "Host_Test.h"
+
+
+#define TEST_STRESS_ITEMS		2000000UL
+
+
+/* Work log of the post / drain checks */
+static u32 TEST_u32Log[64];
+static u32 TEST_u32LogCount = 0;
+
+/* Stand-in for the flash vector table that SCB_RelocateVectorTable copies */
+static u32 TEST_u32FlashVectors[SCB_VECTOR_TABLE_SIZE];
+
+static DEFER_Queue_Type TEST_Ring;
+static DEFER_Queue_Type TEST_Queues[3];
+
+
+static void TEST_LogWork(void * Arg)
+{
+	if(TEST_u32LogCount < 64U)
+	{
+		TEST_u32Log[TEST_u32LogCount] = (u32)(unsigned long)Arg;
+	}
+	TEST_u32LogCount++;
+}
+
+
+static void TEST_Ring_OrderAndOverflow(void)
+{
+	DEFER_Work_Type Work;
+	u32 Index;
+	u32 Round;
+
+	/* Start right below the 32-bit wrap of the free running counters */
+	TEST_Ring.Head = 0XFFFFFFF8UL;
+	TEST_Ring.Tail = 0XFFFFFFF8UL;
+	TEST_Ring.Dropped = 0;
+
+	for(Round = 0; Round < 3U; Round++)
+	{
+		for(Index = 0; Index < DEFER_QUEUE_SIZE; Index++)
+		{
+			Work.Function = TEST_LogWork;
+			Work.Arg      = (void *)(unsigned long)(Round * 100U + Index);
+			TEST_CHECK(DEFER_RingPush(&TEST_Ring, &Work) == OK);
+		}
+		TEST_CHECK(DEFER_RingPush(&TEST_Ring, &Work) == ERROR);
+		TEST_CHECK(TEST_Ring.Dropped == Round + 1U);
+
+		for(Index = 0; Index < DEFER_QUEUE_SIZE; Index++)
+		{
+			TEST_CHECK((DEFER_RingPop(&TEST_Ring, &Work) == OK) &&
+					   ((u32)(unsigned long)Work.Arg == Round * 100U + Index));
+		}
+		TEST_CHECK(DEFER_RingPop(&TEST_Ring, &Work) == ERROR);
+	}
+}
+
+
+/* Producer side of the stress test: sequence numbers, retried while the ring is full */
+static void * TEST_Producer(void * Arg)
+{
+	DEFER_Work_Type Work;
+	unsigned long Sequence;
+
+	(void)Arg;
+	Work.Function = TEST_LogWork;
+	for(Sequence = 0; Sequence < TEST_STRESS_ITEMS; Sequence++)
+	{
+		Work.Arg = (void *)Sequence;
+		while(DEFER_RingPush(&TEST_Ring, &Work) != OK)
+		{
+			/*Full, let the consumer catch up*/
+			(void)sched_yield();
+		}
+	}
+	return NULL;
+}
+
+
+static void TEST_Ring_Threads(void)
+{
+	pthread_t Producer;
+	DEFER_Work_Type Work;
+	unsigned long Expected = 0;
+	u32 OutOfOrder = 0;
+
+	TEST_Ring.Head = 0;
+	TEST_Ring.Tail = 0;
+	TEST_Ring.Dropped = 0;
+
+	TEST_CHECK(pthread_create(&Producer, NULL, TEST_Producer, NULL) == 0);
+	while(Expected < TEST_STRESS_ITEMS)
+	{
+		if(DEFER_RingPop(&TEST_Ring, &Work) == OK)
+		{
+			if((unsigned long)Work.Arg != Expected)
+			{
+				OutOfOrder++;
+			}
+			Expected++;
+		}
+		else
+		{
+			(void)sched_yield();
+		}
+	}
+	(void)pthread_join(Producer, NULL);
+
+	TEST_CHECK(OutOfOrder == 0);
+	TEST_CHECK(DEFER_RingPop(&TEST_Ring, &Work) == ERROR);
+}
+
+
+static void TEST_InitWithoutRelocation(void)
+{
+	/* VTOR on the flash table: no handler can be installed */
+	SCB_SimRegisters.VTOR = (u32)TEST_u32FlashVectors;
+
+	TEST_CHECK(DEFER_Init() == ERROR);
+	TEST_CHECK(NVIC_SimRegisters.NVIC_ISER[1] == 0);
+
+	TEST_CHECK(DEFER_RegisterQueue(&TEST_Queues[0], 0) == OK);
+	NVIC_SimRegisters.NVIC_STIR = 0XFFFFFFFFUL;
+	TEST_CHECK(DEFER_Post(&TEST_Queues[0], TEST_LogWork, NULL) == ERROR);
+	TEST_CHECK(NVIC_SimRegisters.NVIC_STIR == 0XFFFFFFFFUL);
+}
+
+
+static void TEST_PostAndDrain(void)
+{
+	SCB_Handler_Type Level0;
+	SCB_Handler_Type Level1;
+	u32 Index;
+
+	SCB_RelocateVectorTable();
+	TEST_CHECK(DEFER_Init() == OK);
+
+	/* The level handlers are in the SRAM table, as the core would fetch them */
+	Level0 = SCB_GetVector(DEFER_LEVEL0_IRQn);
+	Level1 = SCB_GetVector(DEFER_LEVEL1_IRQn);
+	TEST_CHECK((Level0 != NULL) && (Level1 != NULL) && (Level0 != Level1));
+	TEST_CHECK(NVIC_GetPriority(DEFER_LEVEL0_IRQn) == DEFER_LEVEL0_PRIORITY);
+	TEST_CHECK(NVIC_GetPriority(DEFER_LEVEL1_IRQn) == DEFER_LEVEL1_PRIORITY);
+	if((Level0 == NULL) || (Level1 == NULL))
+	{
+		return;
+	}
+
+	/* Queue 0 was registered by the previous test, queues 1 (level 0) and 2 (level 1) now */
+	TEST_CHECK(DEFER_RegisterQueue(&TEST_Queues[1], 0) == OK);
+	TEST_CHECK(DEFER_RegisterQueue(&TEST_Queues[2], 1) == OK);
+
+	/* Producer 0 posts three items, producer 1 one: the drain alternates between them */
+	TEST_CHECK(DEFER_Post(&TEST_Queues[0], TEST_LogWork, (void *)10UL) == OK);
+	TEST_CHECK(DEFER_Post(&TEST_Queues[0], TEST_LogWork, (void *)11UL) == OK);
+	TEST_CHECK(DEFER_Post(&TEST_Queues[0], TEST_LogWork, (void *)12UL) == OK);
+	TEST_CHECK(DEFER_Post(&TEST_Queues[1], TEST_LogWork, (void *)20UL) == OK);
+	TEST_CHECK(NVIC_SimRegisters.NVIC_STIR == (u32)DEFER_LEVEL0_IRQn);
+	TEST_CHECK(DEFER_Post(&TEST_Queues[2], TEST_LogWork, (void *)30UL) == OK);
+	TEST_CHECK(NVIC_SimRegisters.NVIC_STIR == (u32)DEFER_LEVEL1_IRQn);
+
+	/* Nothing runs before the level interrupt */
+	TEST_CHECK(TEST_u32LogCount == 0);
+
+	/* Registering a queue again fails and keeps its pending work */
+	TEST_CHECK(DEFER_RegisterQueue(&TEST_Queues[0], 0) == ERROR);
+	TEST_CHECK(DEFER_RegisterQueue(&TEST_Queues[0], 1) == ERROR);
+	TEST_CHECK((TEST_Queues[0].Head - TEST_Queues[0].Tail) == 3U);
+
+	TEST_u32LogCount = 0;
+	Level0();
+	TEST_CHECK(TEST_u32LogCount == 4U);
+	TEST_CHECK((TEST_u32Log[0] == 10U) && (TEST_u32Log[1] == 20U) &&
+			   (TEST_u32Log[2] == 11U) && (TEST_u32Log[3] == 12U));
+
+	Level1();
+	TEST_CHECK((TEST_u32LogCount == 5U) && (TEST_u32Log[4] == 30U));
+
+	/* Overflow of one producer is reported and counted, the others are not affected */
+	for(Index = 0; Index < DEFER_QUEUE_SIZE; Index++)
+	{
+		TEST_CHECK(DEFER_Post(&TEST_Queues[0], TEST_LogWork, NULL) == OK);
+	}
+	TEST_CHECK(DEFER_Post(&TEST_Queues[0], TEST_LogWork, NULL) == ERROR);
+	TEST_CHECK(TEST_Queues[0].Dropped == 1U);
+	TEST_CHECK(DEFER_Post(&TEST_Queues[1], TEST_LogWork, NULL) == OK);
+	TEST_CHECK(DEFER_Drain(0) == DEFER_QUEUE_SIZE + 1U);
+	TEST_CHECK(DEFER_Drain(0) == 0);
+}
+
+
+int main(void)
+{
+	NVICSIM_Reset();
+
+	TEST_Ring_OrderAndOverflow();
+	TEST_Ring_Threads();
+	TEST_InitWithoutRelocation();
+	TEST_PostAndDrain();
+
+	if(TEST_u32Failures != 0)
+	{
+		printf("%lu check(s) failed\n", (unsigned long)TEST_u32Failures);
+		return 1;
+	}
+	printf("all DEFER checks passed\n");
+	return 0;
+}
@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file           : Host_Test.h
+ * @author         : Ahmed Khaled
+ * @brief          : Host Test Checks Header File
+ ******************************************************************************
+ *
+ * Check macro and failure count shared by the host tests. The definitions are
+ * static: include it from the test source of a tool only, with -I.. (this
+ * directory) next to the include root.
+ * A test main returns 1 when TEST_u32Failures is not 0.
+ */
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <stdio.h>
+
+#include "Libraries/STD_TYPES.h"
+
+
+#define TEST_MAX_REPORTED		20U			/*Failures printed, the further ones are only counted*/
+
+#define TEST_CHECK(Condition)	TEST_Check((Condition), #Condition, __LINE__)
+
+
+static u32 TEST_u32Failures = 0;
+
+
+static void TEST_Check(int Condition, const char * Text, int Line)
+{
+	if(!Condition)
+	{
+		if(TEST_u32Failures < TEST_MAX_REPORTED)
+		{
+			printf("FAIL line %d: %s\n", Line, Text);
+		}
+		TEST_u32Failures++;
+	}
+}
+
+
+#endif /* HOST_TEST_H_ */
@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ * @file           : IRQ_Plan.c
+ * @author         : Ahmed Khaled
+ * @brief          : Interrupt Priority Planner Command Line Tool
+ ******************************************************************************
+ *
+ * Reads the interrupt timings, runs PLAN_Solve and writes a C table for
+ * NVIC_ApplyPriorityTable to stdout; the analysis goes to stderr.
+ *
+ * Build (include paths as for the target: NVIC/, Libraries/):
+ *   gcc -std=c99 -I<include root> IRQ_Plan.c IRQ_Planner.c -o irq_plan
+ *
+ * Input file, one interrupt per line, '#' starts a comment, times in cycles:
+ *   irq <IRQn> <wcet> <min inter-arrival> [<deadline> [<name>]]
+ * A deadline of 0 means the inter-arrival time, an inter-arrival time of 0 a
+ * single request (a deadline is then required). Each IRQn may appear once.
+ * The name (e.g. USART1_IRQn) is used in the generated table instead of the number.
+ *
+ * Exit status: 0 all deadlines met, 1 a deadline is missed, 2 bad input.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "IRQ_Planner.h"
+
+
+static PLAN_Irq_Type PLAN_Irqs[PLAN_MAX_IRQS];
+static PLAN_Result_Type PLAN_Results[PLAN_MAX_IRQS];
+static char PLAN_Names[PLAN_MAX_IRQS][32];
+
+
+int main(int argc, char * argv[])
+{
+	FILE * File;
+	char Line[160];
+	char Command[16];
+	char Name[40];
+	char IrqName[sizeof(PLAN_Names[0])];
+	char * Comment;
+	unsigned long IRQ;
+	unsigned long Wcet;
+	unsigned long Period;
+	unsigned long Deadline;
+	u32 Count = 0;
+	u32 LineNumber = 0;
+	u32 PriorityGroup;
+	u32 Index;
+	int Fields;
+	States_Type State;
+
+	if(argc != 2)
+	{
+		fprintf(stderr, "usage: %s <interrupt timings>\n", argv[0]);
+		return 2;
+	}
+	File = fopen(argv[1], "r");
+	if(File == NULL)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+
+	while(fgets(Line, sizeof(Line), File) != NULL)
+	{
+		LineNumber++;
+		Comment = strchr(Line, '#');
+		if(Comment != NULL)
+		{
+			*Comment = '\0';
+		}
+		if(sscanf(Line, "%15s", Command) != 1)
+		{
+			continue;
+		}
+
+		Deadline = 0;
+		IrqName[0] = '\0';
+		Fields = sscanf(Line, "%*s %lu %lu %lu %lu %31s", &IRQ, &Wcet, &Period, &Deadline, IrqName);
+		if((Count >= PLAN_MAX_IRQS) || (strcmp(Command, "irq") != 0) || (Fields < 3) || (IRQ >= PLAN_MAX_IRQS) ||
+		   ((Deadline == 0) && (Period == 0)))
+		{
+			fprintf(stderr, "%s:%lu: invalid line\n", argv[1], (unsigned long)LineNumber);
+			fclose(File);
+			return 2;
+		}
+		for(Index = 0; Index < Count; Index++)
+		{
+			if((u32)PLAN_Irqs[Index].IRQn == (u32)IRQ)
+			{
+				fprintf(stderr, "%s:%lu: IRQn %lu given twice\n", argv[1], (unsigned long)LineNumber, IRQ);
+				fclose(File);
+				return 2;
+			}
+		}
+		PLAN_Irqs[Count].IRQn           = (IRQn_Type)IRQ;
+		PLAN_Irqs[Count].WcetCycles     = (u32)Wcet;
+		PLAN_Irqs[Count].PeriodCycles   = (u32)Period;
+		PLAN_Irqs[Count].DeadlineCycles = (u32)Deadline;
+		memcpy(PLAN_Names[Count], IrqName, sizeof(IrqName));
+		Count++;
+	}
+	fclose(File);
+
+	if(Count == 0)
+	{
+		fprintf(stderr, "%s: no interrupt\n", argv[1]);
+		return 2;
+	}
+	State = PLAN_Solve(PLAN_Irqs, Count, &PriorityGroup, PLAN_Results);
+
+	fprintf(stderr, "PRIGROUP %lu (%lu pre-emption bits)\n", (unsigned long)PriorityGroup,
+			(unsigned long)(7UL - PriorityGroup));
+	fprintf(stderr, "%5s %7s %4s %10s %10s %10s %s\n", "IRQn", "Preempt", "Sub", "WCET", "Deadline", "Response", "");
+	for(Index = 0; Index < Count; Index++)
+	{
+		fprintf(stderr, "%5lu %7u %4u %10lu %10lu %10llu %s\n", (unsigned long)PLAN_Irqs[Index].IRQn,
+				(unsigned)PLAN_Results[Index].Priority.PreemptPriority, (unsigned)PLAN_Results[Index].Priority.SubPriority,
+				(unsigned long)PLAN_Irqs[Index].WcetCycles,
+				(unsigned long)((PLAN_Irqs[Index].DeadlineCycles != 0) ? PLAN_Irqs[Index].DeadlineCycles : PLAN_Irqs[Index].PeriodCycles),
+				(unsigned long long)PLAN_Results[Index].ResponseCycles,
+				(PLAN_Results[Index].Schedulable == 1) ? "ok" : "MISSED");
+	}
+
+	printf("/* Generated by IRQ_Plan from %s, do not edit. */\n\n", argv[1]);
+	printf("#include \"NVIC/Cortex_M3_NVIC.h\"\n\n");
+	printf("const u32 NVIC_PlanPriorityGroup = %luU;\t\t/*%lu pre-emption bits*/\n\n", (unsigned long)PriorityGroup,
+		   (unsigned long)(7UL - PriorityGroup));
+	printf("const NVIC_PriorityEntry_Type NVIC_PlanPriorityTable[] = {\n");
+	for(Index = 0; Index < Count; Index++)
+	{
+		if(PLAN_Names[Index][0] != '\0')
+		{
+			snprintf(Name, sizeof(Name), "%.31s,", PLAN_Names[Index]);
+		}
+		else
+		{
+			snprintf(Name, sizeof(Name), "(IRQn_Type)%lu,", (unsigned long)PLAN_Irqs[Index].IRQn);
+		}
+		printf("\t{%-26s %2u, %2u},", Name,
+			   (unsigned)PLAN_Results[Index].Priority.PreemptPriority, (unsigned)PLAN_Results[Index].Priority.SubPriority);
+		printf("\t/*Response %llu cycles*/\n", (unsigned long long)PLAN_Results[Index].ResponseCycles);
+	}
+	printf("};\n\n");
+	printf("const u32 NVIC_PlanPriorityEntries = sizeof(NVIC_PlanPriorityTable) / sizeof(NVIC_PlanPriorityTable[0]);\n");
+
+	return (State == OK) ? 0 : 1;
+}
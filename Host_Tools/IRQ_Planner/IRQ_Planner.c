@@ -0,0 +1,294 @@
+/**
+ ******************************************************************************
+ * @file           : IRQ_Planner.c
+ * @author         : Ahmed Khaled
+ * @brief          : Interrupt Priority Planner Source File
+ ******************************************************************************/
+
+#include "IRQ_Planner.h"
+
+
+#define PLAN_PRIO_BITS			4U					/*NVIC_PRIO_BITS of the STM32F103*/
+
+/* One planning attempt, indexed by deadline-monotonic rank */
+typedef struct {
+	u32 Level[PLAN_MAX_IRQS];			// Pre-emption priority
+	u32 Sub[PLAN_MAX_IRQS];				// Sub-priority
+	u64 Response[PLAN_MAX_IRQS];
+	u32 Levels;							// Distinct pre-emption levels in use
+	f64 WorstSlack;						// min (D - R) / D over all interrupts
+	u8  Schedulable;
+} PLAN_Attempt_Type;
+
+/* Input sorted by deadline, then period, then IRQn */
+static PLAN_Irq_Type PLAN_Sorted[PLAN_MAX_IRQS];
+static u32 PLAN_u32InputIndex[PLAN_MAX_IRQS];
+static u32 PLAN_u32Count;
+
+
+static u64 PLAN_Deadline(const PLAN_Irq_Type * Irq)
+{
+	return (Irq->DeadlineCycles != 0) ? Irq->DeadlineCycles : Irq->PeriodCycles;
+}
+
+
+/* Deadline-monotonic order, insertion sort (at most 60 entries) */
+static void PLAN_Sort(const PLAN_Irq_Type * Irqs, u32 Count)
+{
+	u32 Index;
+	u32 Slot;
+
+	for(Index = 0; Index < Count; Index++)
+	{
+		Slot = Index;
+		while((Slot > 0) &&
+			  ((PLAN_Deadline(&Irqs[Index]) < PLAN_Deadline(&PLAN_Sorted[Slot - 1])) ||
+			   ((PLAN_Deadline(&Irqs[Index]) == PLAN_Deadline(&PLAN_Sorted[Slot - 1])) &&
+				((Irqs[Index].PeriodCycles < PLAN_Sorted[Slot - 1].PeriodCycles) ||
+				 ((Irqs[Index].PeriodCycles == PLAN_Sorted[Slot - 1].PeriodCycles) &&
+				  ((s32)Irqs[Index].IRQn < (s32)PLAN_Sorted[Slot - 1].IRQn))))))
+		{
+			PLAN_Sorted[Slot]        = PLAN_Sorted[Slot - 1];
+			PLAN_u32InputIndex[Slot] = PLAN_u32InputIndex[Slot - 1];
+			Slot--;
+		}
+		PLAN_Sorted[Slot]        = Irqs[Index];
+		PLAN_u32InputIndex[Slot] = Index;
+	}
+	PLAN_u32Count = Count;
+}
+
+
+/* 1 when j is taken before i once both are pending in the same group: (sub-priority, IRQn) as the NVIC */
+static u8 PLAN_FirstInGroup(const PLAN_Attempt_Type * Attempt, u32 j, u32 i)
+{
+	return (u8)((Attempt->Sub[j] < Attempt->Sub[i]) ||
+				((Attempt->Sub[j] == Attempt->Sub[i]) && ((s32)PLAN_Sorted[j].IRQn < (s32)PLAN_Sorted[i].IRQn)));
+}
+
+
+/* Requests of j within a window of Window cycles: a one-shot interrupt (no period) still arrives once */
+static u64 PLAN_Arrivals(u64 Window, u32 PeriodCycles)
+{
+	return (PeriodCycles == 0) ? 1 : ((Window + PeriodCycles - 1) / PeriodCycles);
+}
+
+
+/*
+ * Response time of interrupt i:
+ *   R = entry + C(i) + B + sum over higher groups   ceil(R / T) * (C + entry + exit)
+ *                        + sum over same group, first ceil(R / T) * (C + tail-chain)
+ * (ceil(R / T) is 1 for an interrupt without period.)
+ * B is the longest handler of the same group taken after i (it can not be pre-empted by i)
+ * plus one tail-chain. Same-group handlers run back to back, so they cost a tail-chain only.
+ */
+static void PLAN_Analyse(PLAN_Attempt_Type * Attempt)
+{
+	u32 i;
+	u32 j;
+	u64 Base;
+	u64 Blocking;
+	u64 Response;
+	u64 Next;
+	u64 Deadline;
+	f64 Slack;
+
+	Attempt->Schedulable = 1;
+	Attempt->WorstSlack  = 1.0;
+
+	for(i = 0; i < PLAN_u32Count; i++)
+	{
+		Deadline = PLAN_Deadline(&PLAN_Sorted[i]);
+
+		Blocking = 0;
+		for(j = 0; j < PLAN_u32Count; j++)
+		{
+			if((j != i) && (Attempt->Level[j] == Attempt->Level[i]) && (PLAN_FirstInGroup(Attempt, j, i) == 0) &&
+			   ((PLAN_Sorted[j].WcetCycles + PLAN_TAILCHAIN_CYCLES) > Blocking))
+			{
+				Blocking = PLAN_Sorted[j].WcetCycles + PLAN_TAILCHAIN_CYCLES;
+			}
+		}
+
+		Base = PLAN_ENTRY_CYCLES + PLAN_Sorted[i].WcetCycles + Blocking;
+		Response = Base;
+		for(;;)
+		{
+			Next = Base;
+			for(j = 0; j < PLAN_u32Count; j++)
+			{
+				if(j == i)
+				{
+					continue;
+				}
+				if(Attempt->Level[j] < Attempt->Level[i])
+				{
+					Next += PLAN_Arrivals(Response, PLAN_Sorted[j].PeriodCycles) *
+							((u64)PLAN_Sorted[j].WcetCycles + PLAN_ENTRY_CYCLES + PLAN_EXIT_CYCLES);
+				}
+				else if((Attempt->Level[j] == Attempt->Level[i]) && (PLAN_FirstInGroup(Attempt, j, i) == 1))
+				{
+					Next += PLAN_Arrivals(Response, PLAN_Sorted[j].PeriodCycles) *
+							((u64)PLAN_Sorted[j].WcetCycles + PLAN_TAILCHAIN_CYCLES);
+				}
+				else
+				{
+					/*Lower group: pre-empted by i*/
+				}
+			}
+
+			if((Next == Response) || (Next > Deadline))
+			{
+				Response = Next;
+				break;
+			}
+			Response = Next;
+		}
+
+		Attempt->Response[i] = Response;
+		if(Response > Deadline)
+		{
+			Attempt->Schedulable = 0;
+		}
+		Slack = ((f64)Deadline - (f64)Response) / (f64)Deadline;
+		if(Slack < Attempt->WorstSlack)
+		{
+			Attempt->WorstSlack = Slack;
+		}
+	}
+}
+
+
+/* Sub-priorities follow the deadline-monotonic rank inside each group, the last ones share the lowest */
+static void PLAN_AssignSub(PLAN_Attempt_Type * Attempt, u32 SubLevels)
+{
+	u32 Index;
+	u32 Rank = 0;
+
+	for(Index = 0; Index < PLAN_u32Count; Index++)
+	{
+		Rank = ((Index == 0) || (Attempt->Level[Index] != Attempt->Level[Index - 1])) ? 0 : (Rank + 1);
+		Attempt->Sub[Index] = (Rank < SubLevels) ? Rank : (SubLevels - 1);
+	}
+}
+
+
+/* Joins the levels of a group with the next one */
+static void PLAN_MergeLevels(PLAN_Attempt_Type * Attempt, u32 Level)
+{
+	u32 Index;
+
+	for(Index = 0; Index < PLAN_u32Count; Index++)
+	{
+		if(Attempt->Level[Index] > Level)
+		{
+			Attempt->Level[Index]--;
+		}
+	}
+	Attempt->Levels--;
+}
+
+
+/* Greedy plan for a number of pre-emption bits */
+static void PLAN_Plan(PLAN_Attempt_Type * Attempt, u32 PreemptBits)
+{
+	PLAN_Attempt_Type Trial;
+	u32 MaxLevels = 1UL << PreemptBits;
+	u32 SubLevels = 1UL << (PLAN_PRIO_BITS - PreemptBits);
+	u32 Index;
+	u32 Level;
+	u32 BestLevel;
+	f64 BestSlack;
+
+	/* Start with one level per interrupt */
+	for(Index = 0; Index < PLAN_u32Count; Index++)
+	{
+		Attempt->Level[Index] = Index;
+	}
+	Attempt->Levels = PLAN_u32Count;
+
+	/* Merge the two neighbouring levels whose merge hurts the worst slack least */
+	while(Attempt->Levels > MaxLevels)
+	{
+		BestLevel = 0;
+		BestSlack = -1.0e300;
+		for(Level = 0; (Level + 1) < Attempt->Levels; Level++)
+		{
+			Trial = *Attempt;
+			PLAN_MergeLevels(&Trial, Level);
+			PLAN_AssignSub(&Trial, SubLevels);
+			PLAN_Analyse(&Trial);
+			if(Trial.WorstSlack > BestSlack)
+			{
+				BestSlack = Trial.WorstSlack;
+				BestLevel = Level;
+			}
+		}
+		PLAN_MergeLevels(Attempt, BestLevel);
+	}
+
+	PLAN_AssignSub(Attempt, SubLevels);
+	PLAN_Analyse(Attempt);
+}
+
+
+States_Type PLAN_Solve(const PLAN_Irq_Type * Irqs, u32 Count, u32 * pPriorityGroup, PLAN_Result_Type * Results)
+{
+	static PLAN_Attempt_Type Attempt;
+	static PLAN_Attempt_Type Best;
+	u32 PreemptBits;
+	u32 BestBits = PLAN_PRIO_BITS;
+	u32 Index;
+	u32 Other;
+	u8  HaveBest = 0;
+
+	if((Irqs == NULL) || (Results == NULL) || (pPriorityGroup == NULL) || (Count == 0) || (Count > PLAN_MAX_IRQS))
+	{
+		return ERROR;
+	}
+	for(Index = 0; Index < Count; Index++)
+	{
+		if(((s32)Irqs[Index].IRQn < 0) || ((u32)Irqs[Index].IRQn >= PLAN_MAX_IRQS) ||
+		   (PLAN_Deadline(&Irqs[Index]) == 0))
+		{
+			return ERROR;
+		}
+		/* One priority per interrupt: a second entry would silently override the first */
+		for(Other = 0; Other < Index; Other++)
+		{
+			if(Irqs[Other].IRQn == Irqs[Index].IRQn)
+			{
+				return ERROR;
+			}
+		}
+	}
+
+	PLAN_Sort(Irqs, Count);
+
+	for(PreemptBits = PLAN_PRIO_BITS + 1; PreemptBits-- > 0;)
+	{
+		PLAN_Plan(&Attempt, PreemptBits);
+		if((HaveBest == 0) || (Attempt.Schedulable > Best.Schedulable) ||
+		   ((Attempt.Schedulable == Best.Schedulable) && (Attempt.WorstSlack > Best.WorstSlack)))
+		{
+			Best     = Attempt;
+			BestBits = PreemptBits;
+			HaveBest = 1;
+		}
+	}
+
+	/* PRIGROUP 7 - n leaves n pre-emption bits (SCB_PRIORITYGROUP_4 = 3 for all four) */
+	*pPriorityGroup = 7UL - BestBits;
+
+	for(Index = 0; Index < Count; Index++)
+	{
+		Results[PLAN_u32InputIndex[Index]].Priority.IRQn            = PLAN_Sorted[Index].IRQn;
+		Results[PLAN_u32InputIndex[Index]].Priority.PreemptPriority = (u8)Best.Level[Index];
+		Results[PLAN_u32InputIndex[Index]].Priority.SubPriority     = (u8)Best.Sub[Index];
+		Results[PLAN_u32InputIndex[Index]].ResponseCycles           = Best.Response[Index];
+		Results[PLAN_u32InputIndex[Index]].Schedulable              =
+			(u8)(Best.Response[Index] <= PLAN_Deadline(&PLAN_Sorted[Index]));
+	}
+
+	return (Best.Schedulable == 1) ? OK : ERROR;
+}
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file           : IRQ_Planner.h
+ * @author         : Ahmed Khaled
+ * @brief          : Interrupt Priority Planner Header File
+ ******************************************************************************
+ *
+ * Host library that chooses the priority grouping and the pre-emption /
+ * sub-priority of every interrupt from its worst-case execution time, minimum
+ * inter-arrival time and deadline, using deadline-monotonic ordering and
+ * response-time analysis with the Cortex-M3 exception entry, exit and
+ * tail-chain costs.
+ */
+
+#ifndef IRQ_PLANNER_H_
+#define IRQ_PLANNER_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+#include "NVIC/Cortex_M3_NVIC.h"
+/***************************************End Include Section*****************/
+
+/********************************************Macro Section Start********************************/
+
+#define PLAN_MAX_IRQS					60U			/*Device interrupts of the STM32F103*/
+
+#define PLAN_ENTRY_CYCLES				12U			/*Stacking + vector fetch*/
+#define PLAN_EXIT_CYCLES				12U			/*Unstacking back to the pre-empted context*/
+#define PLAN_TAILCHAIN_CYCLES			6U			/*Back-to-back handlers of the same group*/
+
+/********************************************Macro End Section**********************************/
+
+/******************************Start Data Type Section***********************/
+
+/* Timing of one interrupt, all values in core cycles */
+typedef struct {
+	IRQn_Type IRQn;
+	u32 WcetCycles;						// Worst-case handler execution time
+	u32 PeriodCycles;					// Minimum time between two requests (0 = one request only)
+	u32 DeadlineCycles;					// Request -> handler end bound (0 = PeriodCycles)
+} PLAN_Irq_Type;
+
+/* Planned priority of one interrupt (same order as the input) */
+typedef struct {
+	NVIC_PriorityEntry_Type Priority;
+	u64 ResponseCycles;					// Worst-case request -> handler end
+	u8  Schedulable;					// 1 when ResponseCycles <= deadline
+} PLAN_Result_Type;
+
+/******************************End Data Type Section***********************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Solve
+ *  details		Orders the interrupts deadline-monotonically, then for every priority grouping
+ *  			merges neighbouring priority levels until they fit the pre-emption bits, keeping
+ *  			the largest relative slack. The grouping with the best worst slack is returned.
+ *  param [in]	Irqs            Interrupt timings
+ *  param [in]	Count           Number of interrupts (<= PLAN_MAX_IRQS)
+ *  param [out]	pPriorityGroup  SCB_PRIORITYGROUP_x to apply
+ *  param [out]	Results         Priority and response time of each interrupt
+ *  return		OK     Every deadline is met
+ *  return		ERROR  Invalid input (IRQn outside 0 .. PLAN_MAX_IRQS - 1, an IRQn given twice, no
+ *  					deadline) or at least one deadline is missed (Results hold the best plan)
+ */
+States_Type PLAN_Solve(const PLAN_Irq_Type * Irqs, u32 Count, u32 * pPriorityGroup, PLAN_Result_Type * Results);
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* IRQ_PLANNER_H_ */
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file           : NVIC_Bench.c
+ * @author         : Ahmed Khaled
+ * @brief          : Interrupt Trace Replay Benchmark
+ ******************************************************************************
+ *
+ * Replays a recorded interrupt trace on the simulated NVIC, with the priorities
+ * applied through the real NVIC / SCB drivers, and prints the worst-case latency
+ * and response time of every interrupt.
+ *
+ * Build (include paths as for the target: NVIC/, SCB/, Libraries/):
+ *   gcc -std=c99 -DCORE_SIMULATION -I<include root> NVIC_Bench.c NVIC_Sim.c \
+ *       Cortex_M3_NVIC.c Cortex_M3_SCB.c -o nvic_bench
+ *
+ * Trace file, one command per line, '#' starts a comment:
+ *   group <PRIGROUP>                      e.g. 3 = SCB_PRIORITYGROUP_4
+ *   irq   <IRQn> <priority> <cycles>      priority 0..15, handler body cycles
+ *   event <cycle> <IRQn>                  interrupt request
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NVIC_Sim.h"
+
+
+#define BENCH_MAX_EVENTS		100000U
+
+static NVICSIM_Event_Type BENCH_Events[BENCH_MAX_EVENTS];
+static u8 BENCH_u8Used[NVICSIM_IRQS_NUM];
+
+
+static int BENCH_CompareEvents(const void * Left, const void * Right)
+{
+	const NVICSIM_Event_Type * A = (const NVICSIM_Event_Type *) Left;
+	const NVICSIM_Event_Type * B = (const NVICSIM_Event_Type *) Right;
+
+	return (A->Time > B->Time) - (A->Time < B->Time);
+}
+
+
+int main(int argc, char * argv[])
+{
+	FILE * File;
+	char Line[128];
+	char Command[16];
+	unsigned long long Value0;
+	unsigned long Value1;
+	unsigned long Value2;
+	u32 Events = 0;
+	u32 LineNumber = 0;
+	u32 IRQ;
+	u64 End;
+	NVICSIM_Stats_Type Stats;
+
+	if(argc != 2)
+	{
+		fprintf(stderr, "usage: %s <trace file>\n", argv[0]);
+		return 2;
+	}
+	File = fopen(argv[1], "r");
+	if(File == NULL)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+
+	NVICSIM_Reset();
+
+	while(fgets(Line, sizeof(Line), File) != NULL)
+	{
+		LineNumber++;
+		if((Line[0] == '#') || (sscanf(Line, "%15s", Command) != 1))
+		{
+			continue;
+		}
+
+		if((strcmp(Command, "group") == 0) && (sscanf(Line, "%*s %llu", &Value0) == 1))
+		{
+			SCB_SetPriorityGrouping((u32)Value0);
+			NVICSIM_Sync();
+		}
+		else if((strcmp(Command, "irq") == 0) && (sscanf(Line, "%*s %llu %lu %lu", &Value0, &Value1, &Value2) == 3) &&
+				(Value0 < NVICSIM_IRQS_NUM))
+		{
+			NVIC_SetPriority((IRQn_Type)Value0, (u32)Value1);
+			NVIC_EnableIRQ((IRQn_Type)Value0);
+			NVICSIM_Sync();
+			NVICSIM_SetHandler((IRQn_Type)Value0, (u32)Value2, NULL);
+			BENCH_u8Used[Value0] = 1;
+		}
+		else if((strcmp(Command, "event") == 0) && (sscanf(Line, "%*s %llu %lu", &Value0, &Value1) == 2) &&
+				(Value1 < NVICSIM_IRQS_NUM) && (Events < BENCH_MAX_EVENTS))
+		{
+			BENCH_Events[Events].Time = (u64)Value0;
+			BENCH_Events[Events].IRQn = (IRQn_Type)Value1;
+			Events++;
+		}
+		else
+		{
+			fprintf(stderr, "%s:%lu: ignored: %s", argv[1], (unsigned long)LineNumber, Line);
+		}
+	}
+	fclose(File);
+
+	qsort(BENCH_Events, Events, sizeof(BENCH_Events[0]), BENCH_CompareEvents);
+	End = NVICSIM_Run(BENCH_Events, Events);
+
+	printf("PRIGROUP %lu, %lu events, last handler done at cycle %llu\n",
+		   (unsigned long)SCB_GetPriorityGrouping(), (unsigned long)Events, (unsigned long long)End);
+	printf("%5s %4s %4s %8s %8s %8s %9s %9s %9s\n",
+		   "IRQn", "Prio", "Grp", "Count", "Preempt", "TailCh", "AvgLat", "MaxLat", "MaxResp");
+
+	for(IRQ = 0; IRQ < NVICSIM_IRQS_NUM; IRQ++)
+	{
+		if((BENCH_u8Used[IRQ] == 0) || (NVICSIM_GetStats((IRQn_Type)IRQ, &Stats) != OK))
+		{
+			continue;
+		}
+		printf("%5lu %4lu %4lu %8lu %8lu %8lu %9llu %9llu %9llu\n",
+			   (unsigned long)IRQ, (unsigned long)NVIC_GetPriority((IRQn_Type)IRQ),
+			   (unsigned long)NVICSIM_GroupPriority((IRQn_Type)IRQ),
+			   (unsigned long)Stats.Count, (unsigned long)Stats.Preemptions, (unsigned long)Stats.TailChains,
+			   (unsigned long long)((Stats.Count != 0) ? (Stats.TotalLatency / Stats.Count) : 0),
+			   (unsigned long long)Stats.MaxLatency, (unsigned long long)Stats.MaxResponse);
+	}
+	return 0;
+}
@@ -0,0 +1,361 @@
+/**
+ ******************************************************************************
+ * @file           : NVIC_Sim.c
+ * @author         : Ahmed Khaled
+ * @brief          : Host NVIC / SCB Simulator Source File
+ ******************************************************************************/
+
+#include "NVIC_Sim.h"
+
+
+#define NVICSIM_WORDS			2U							/*Words holding IRQn 0..59*/
+#define NVICSIM_STIR_IDLE		0XFFFFFFFFUL				/*STIR value meaning "not written"*/
+#define NVICSIM_AIRCR_VECTKEY	(0XFA05UL << 16)			/*VECTKEYSTAT read value*/
+#define NVICSIM_NO_IRQ			0XFFFFFFFFUL
+#define NVICSIM_NO_PRIORITY		0X100UL						/*Below any 8-bit priority (thread mode)*/
+
+/* Registers the drivers access when built with CORE_SIMULATION */
+NVIC_Type NVIC_SimRegisters;
+SCB_Type  SCB_SimRegisters;
+
+/* Valid interrupt bits of each word */
+static const u32 NVICSIM_WordMask[NVICSIM_WORDS] = {0XFFFFFFFFUL, 0X0FFFFFFFUL};
+
+/* Internal interrupt state, the registers only mirror it */
+static u32 NVICSIM_u32Enabled[NVICSIM_WORDS];
+static u32 NVICSIM_u32Pending[NVICSIM_WORDS];
+static u32 NVICSIM_u32Active[NVICSIM_WORDS];
+static u32 NVICSIM_u32PriorityGroup;
+
+typedef struct {
+	u32 IRQn;
+	u64 Remaining;						// Body cycles still to execute
+	u64 SliceStart;						// Cycle the body (re)starts executing
+	u64 PendTime;						// Request time of this activation
+} NVICSIM_Frame_Type;
+
+static NVICSIM_Frame_Type NVICSIM_Frames[NVICSIM_MAX_NESTING];
+static u32 NVICSIM_u32Depth;
+
+static u64 NVICSIM_u64Now;
+static u64 NVICSIM_u64PendTime[NVICSIM_IRQS_NUM];
+static u32 NVICSIM_u32ExecCycles[NVICSIM_IRQS_NUM];
+static NVICSIM_Handler_Type NVICSIM_Hooks[NVICSIM_IRQS_NUM];
+static NVICSIM_Stats_Type NVICSIM_Stats[NVICSIM_IRQS_NUM];
+
+
+#define NVICSIM_GET(Array, IRQ)		(((Array)[(IRQ) >> 5] >> ((IRQ) & 0X1FUL)) & 1UL)
+#define NVICSIM_SET(Array, IRQ)		((Array)[(IRQ) >> 5] |= (1UL << ((IRQ) & 0X1FUL)))
+#define NVICSIM_CLR(Array, IRQ)		((Array)[(IRQ) >> 5] &= ~(1UL << ((IRQ) & 0X1FUL)))
+
+
+/* Refresh what the drivers read back */
+static void NVICSIM_Writeback(void)
+{
+	u32 Word;
+
+	for(Word = 0; Word < NVICSIM_WORDS; Word++)
+	{
+		NVIC_SimRegisters.NVIC_ISER[Word] = NVICSIM_u32Enabled[Word];
+		NVIC_SimRegisters.NVIC_ICER[Word] = 0;
+		NVIC_SimRegisters.NVIC_ISPR[Word] = NVICSIM_u32Pending[Word];
+		NVIC_SimRegisters.NVIC_ICPR[Word] = 0;
+		NVIC_SimRegisters.NVIC_IABR[Word] = NVICSIM_u32Active[Word];
+	}
+	NVIC_SimRegisters.NVIC_STIR = NVICSIM_STIR_IDLE;
+	SCB_SimRegisters.AIRCR = NVICSIM_AIRCR_VECTKEY | (NVICSIM_u32PriorityGroup << SCB_AIRCR_PRIGROUP_POS);
+}
+
+
+static void NVICSIM_Raise(u32 IRQ)
+{
+	if(NVICSIM_GET(NVICSIM_u32Pending, IRQ) == 0)
+	{
+		NVICSIM_SET(NVICSIM_u32Pending, IRQ);
+		NVICSIM_u64PendTime[IRQ] = NVICSIM_u64Now;
+	}
+}
+
+
+void NVICSIM_Sync(void)
+{
+	u32 Word;
+	u32 Before;
+	u32 Set;
+	u32 IRQ;
+
+	for(Word = 0; Word < NVICSIM_WORDS; Word++)
+	{
+		/* Write-one-to-set / write-one-to-clear: the registers hold the state or what was written */
+		NVICSIM_u32Enabled[Word] |=  (NVIC_SimRegisters.NVIC_ISER[Word] & NVICSIM_WordMask[Word]);
+		NVICSIM_u32Enabled[Word] &= ~(NVIC_SimRegisters.NVIC_ICER[Word]);
+
+		Before = NVICSIM_u32Pending[Word];
+		NVICSIM_u32Pending[Word] |=  (NVIC_SimRegisters.NVIC_ISPR[Word] & NVICSIM_WordMask[Word]);
+		NVICSIM_u32Pending[Word] &= ~(NVIC_SimRegisters.NVIC_ICPR[Word]);
+
+		/* Request time of the interrupts pended by software */
+		Set = NVICSIM_u32Pending[Word] & ~Before;
+		for(IRQ = 0; Set != 0; IRQ++, Set >>= 1)
+		{
+			if((Set & 1UL) != 0)
+			{
+				NVICSIM_u64PendTime[(Word << 5) + IRQ] = NVICSIM_u64Now;
+			}
+		}
+	}
+
+	if(NVIC_SimRegisters.NVIC_STIR != NVICSIM_STIR_IDLE)
+	{
+		IRQ = (u32)(NVIC_SimRegisters.NVIC_STIR & 0X1FFUL);
+		if(IRQ < NVICSIM_IRQS_NUM)
+		{
+			NVICSIM_Raise(IRQ);
+		}
+	}
+
+	NVICSIM_u32PriorityGroup = (u32)((SCB_SimRegisters.AIRCR >> SCB_AIRCR_PRIGROUP_POS) & 0X07UL);
+
+	NVICSIM_Writeback();
+}
+
+
+void NVICSIM_Reset(void)
+{
+	u32 Index;
+	u8 * Byte;
+
+	Byte = (u8 *) &NVIC_SimRegisters;
+	for(Index = 0; Index < sizeof(NVIC_SimRegisters); Index++)
+	{
+		Byte[Index] = 0;
+	}
+	Byte = (u8 *) &SCB_SimRegisters;
+	for(Index = 0; Index < sizeof(SCB_SimRegisters); Index++)
+	{
+		Byte[Index] = 0;
+	}
+
+	for(Index = 0; Index < NVICSIM_WORDS; Index++)
+	{
+		NVICSIM_u32Enabled[Index] = 0;
+		NVICSIM_u32Pending[Index] = 0;
+		NVICSIM_u32Active[Index]  = 0;
+	}
+	for(Index = 0; Index < NVICSIM_IRQS_NUM; Index++)
+	{
+		NVICSIM_u64PendTime[Index]   = 0;
+		NVICSIM_u32ExecCycles[Index] = 0;
+		NVICSIM_Hooks[Index]         = NULL;
+		NVICSIM_Stats[Index] = (NVICSIM_Stats_Type){0};
+	}
+	NVICSIM_u32PriorityGroup = 0;
+	NVICSIM_u32Depth = 0;
+	NVICSIM_u64Now   = 0;
+
+	NVICSIM_Writeback();
+}
+
+
+void NVICSIM_SetHandler(IRQn_Type IRQn, u32 ExecCycles, NVICSIM_Handler_Type Hook)
+{
+	if(((s32)IRQn >= 0) && ((u32)IRQn < NVICSIM_IRQS_NUM))
+	{
+		NVICSIM_u32ExecCycles[IRQn] = ExecCycles;
+		NVICSIM_Hooks[IRQn]         = Hook;
+	}
+}
+
+
+u32 NVICSIM_GroupPriority(IRQn_Type IRQn)
+{
+	u32 Shift = NVICSIM_u32PriorityGroup + 1UL;		// PRIGROUP n: bits [7:n+1] are the group priority
+
+	if(((s32)IRQn < 0) || ((u32)IRQn >= NVICSIM_IRQS_NUM))
+	{
+		return NVICSIM_NO_PRIORITY;
+	}
+	return (Shift >= 8UL) ? 0UL : ((u32)NVIC_SimRegisters.NVIC_IP[IRQn] >> Shift);
+}
+
+
+/* Group priority the core runs at */
+static u32 NVICSIM_ExecutionPriority(void)
+{
+	/* Each frame pre-empted the one below, the top one has the highest priority */
+	return (NVICSIM_u32Depth == 0) ? NVICSIM_NO_PRIORITY :
+			NVICSIM_GroupPriority((IRQn_Type)NVICSIM_Frames[NVICSIM_u32Depth - 1].IRQn);
+}
+
+
+/* Pending and enabled interrupt the NVIC would take: full priority, then lowest IRQn */
+static u32 NVICSIM_BestPending(void)
+{
+	u32 IRQ;
+	u32 Best = NVICSIM_NO_IRQ;
+
+	for(IRQ = 0; IRQ < NVICSIM_IRQS_NUM; IRQ++)
+	{
+		if((NVICSIM_GET(NVICSIM_u32Pending, IRQ) != 0) && (NVICSIM_GET(NVICSIM_u32Enabled, IRQ) != 0) &&
+		   (NVICSIM_GET(NVICSIM_u32Active, IRQ) == 0) &&
+		   ((Best == NVICSIM_NO_IRQ) || (NVIC_SimRegisters.NVIC_IP[IRQ] < NVIC_SimRegisters.NVIC_IP[Best])))
+		{
+			Best = IRQ;
+		}
+	}
+	return Best;
+}
+
+
+/* Starts every handler allowed to run now, EntryCycles for the first one */
+static void NVICSIM_Dispatch(u32 EntryCycles, u8 TailChain)
+{
+	NVICSIM_Frame_Type * Frame;
+	u32 IRQ = NVICSIM_BestPending();
+	u64 Consumed;
+
+	while((IRQ != NVICSIM_NO_IRQ) && (NVICSIM_u32Depth < NVICSIM_MAX_NESTING) &&
+		  (NVICSIM_GroupPriority((IRQn_Type)IRQ) < NVICSIM_ExecutionPriority()))
+	{
+		if(TailChain == 1)
+		{
+			/* The frame below is still pre-empted, its remaining time is unchanged */
+			NVICSIM_Stats[IRQ].TailChains++;
+		}
+		else if(NVICSIM_u32Depth != 0)
+		{
+			Frame = &NVICSIM_Frames[NVICSIM_u32Depth - 1];
+			Consumed = (NVICSIM_u64Now > Frame->SliceStart) ? (NVICSIM_u64Now - Frame->SliceStart) : 0;
+			Frame->Remaining -= (Consumed < Frame->Remaining) ? Consumed : Frame->Remaining;
+			NVICSIM_Stats[IRQ].Preemptions++;
+		}
+		else
+		{
+			/*Taken from thread mode*/
+		}
+
+		Frame = &NVICSIM_Frames[NVICSIM_u32Depth];
+		NVICSIM_u32Depth++;
+		Frame->IRQn       = IRQ;
+		Frame->Remaining  = NVICSIM_u32ExecCycles[IRQ];
+		Frame->SliceStart = NVICSIM_u64Now + EntryCycles;
+		Frame->PendTime   = NVICSIM_u64PendTime[IRQ];
+
+		NVICSIM_CLR(NVICSIM_u32Pending, IRQ);
+		NVICSIM_SET(NVICSIM_u32Active, IRQ);
+
+		NVICSIM_Stats[IRQ].Count++;
+		NVICSIM_Stats[IRQ].TotalLatency += Frame->SliceStart - Frame->PendTime;
+		if((Frame->SliceStart - Frame->PendTime) > NVICSIM_Stats[IRQ].MaxLatency)
+		{
+			NVICSIM_Stats[IRQ].MaxLatency = Frame->SliceStart - Frame->PendTime;
+		}
+		NVICSIM_Writeback();
+
+		if(NVICSIM_Hooks[IRQ] != NULL)
+		{
+			NVICSIM_Hooks[IRQ]((IRQn_Type)IRQ);
+			NVICSIM_Sync();
+		}
+
+		/* A request raised now has to pre-empt the handler being entered */
+		EntryCycles = NVICSIM_ENTRY_CYCLES;
+		TailChain   = 0;
+		IRQ = NVICSIM_BestPending();
+	}
+}
+
+
+/* Ends the running handler: tail-chain, return to the pre-empted one or to thread mode */
+static void NVICSIM_Complete(void)
+{
+	NVICSIM_Frame_Type * Frame;
+	u32 IRQ;
+
+	NVICSIM_u32Depth--;
+	Frame = &NVICSIM_Frames[NVICSIM_u32Depth];
+	IRQ = Frame->IRQn;
+
+	NVICSIM_CLR(NVICSIM_u32Active, IRQ);
+	if((NVICSIM_u64Now - Frame->PendTime) > NVICSIM_Stats[IRQ].MaxResponse)
+	{
+		NVICSIM_Stats[IRQ].MaxResponse = NVICSIM_u64Now - Frame->PendTime;
+	}
+	NVICSIM_Writeback();
+
+	IRQ = NVICSIM_BestPending();
+	if((IRQ != NVICSIM_NO_IRQ) && (NVICSIM_GroupPriority((IRQn_Type)IRQ) < NVICSIM_ExecutionPriority()))
+	{
+		/* Skip unstacking + stacking */
+		NVICSIM_Dispatch(NVICSIM_TAILCHAIN_CYCLES, 1);
+	}
+	else if(NVICSIM_u32Depth != 0)
+	{
+		NVICSIM_Frames[NVICSIM_u32Depth - 1].SliceStart = NVICSIM_u64Now + NVICSIM_EXIT_CYCLES;
+	}
+	else
+	{
+		/*Back to thread mode*/
+	}
+}
+
+
+u64 NVICSIM_Run(const NVICSIM_Event_Type * Trace, u32 Events)
+{
+	const u64 Never = ~(u64)0;
+	u64 Arrival;
+	u64 Done;
+	u64 LastDone = NVICSIM_u64Now;
+	u32 Index = 0;
+
+	for(;;)
+	{
+		NVICSIM_Sync();
+		NVICSIM_Dispatch(NVICSIM_ENTRY_CYCLES, 0);
+
+		Arrival = Never;
+		if(Index < Events)
+		{
+			Arrival = (Trace[Index].Time > NVICSIM_u64Now) ? Trace[Index].Time : NVICSIM_u64Now;
+		}
+		Done = Never;
+		if(NVICSIM_u32Depth != 0)
+		{
+			Done = NVICSIM_Frames[NVICSIM_u32Depth - 1].SliceStart + NVICSIM_Frames[NVICSIM_u32Depth - 1].Remaining;
+		}
+
+		if((Arrival == Never) && (Done == Never))
+		{
+			break;
+		}
+
+		if(Arrival <= Done)
+		{
+			NVICSIM_u64Now = Arrival;
+			if(((s32)Trace[Index].IRQn >= 0) && ((u32)Trace[Index].IRQn < NVICSIM_IRQS_NUM))
+			{
+				NVICSIM_Raise((u32)Trace[Index].IRQn);
+				NVICSIM_Writeback();
+			}
+			Index++;
+		}
+		else
+		{
+			NVICSIM_u64Now = Done;
+			LastDone = Done;
+			NVICSIM_Complete();
+		}
+	}
+	return LastDone;
+}
+
+
+States_Type NVICSIM_GetStats(IRQn_Type IRQn, NVICSIM_Stats_Type * Stats)
+{
+	if(((s32)IRQn < 0) || ((u32)IRQn >= NVICSIM_IRQS_NUM) || (Stats == NULL))
+	{
+		return ERROR;
+	}
+	*Stats = NVICSIM_Stats[IRQn];
+	return OK;
+}
@@ -0,0 +1,117 @@
+/**
+ ******************************************************************************
+ * @file           : NVIC_Sim.h
+ * @author         : Ahmed Khaled
+ * @brief          : Host NVIC / SCB Simulator Header File
+ ******************************************************************************
+ *
+ * Cycle-approximate model of the Cortex-M3 NVIC for Linux builds. The real
+ * NVIC and SCB drivers are compiled with -DCORE_SIMULATION, their NVIC and SCB
+ * macros then point at NVIC_SimRegisters / SCB_SimRegisters defined here.
+ *
+ * Modelled: enable / pending / active state with write-one-to-set/clear
+ * registers and STIR, priority grouping from AIRCR PRIGROUP, pre-emption,
+ * tail-chaining, 12 cycle entry / exit and 6 cycle tail-chain.
+ * Not modelled: late arrival, BASEPRI / PRIMASK, system exceptions, bus timing.
+ */
+
+#ifndef NVIC_SIM_H_
+#define NVIC_SIM_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+#include "NVIC/Cortex_M3_NVIC.h"
+#include "SCB/Cortex_M3_SCB.h"
+/***************************************End Include Section*****************/
+
+/********************************************Macro Section Start********************************/
+
+#define NVICSIM_IRQS_NUM				60U			/*Device interrupts of the STM32F103*/
+#define NVICSIM_MAX_NESTING				16U			/*Deepest pre-emption modelled*/
+
+#define NVICSIM_ENTRY_CYCLES			12U			/*Stacking + vector fetch*/
+#define NVICSIM_EXIT_CYCLES				12U			/*Unstacking back to the pre-empted context*/
+#define NVICSIM_TAILCHAIN_CYCLES		6U			/*Exit directly into the next pending handler*/
+
+/********************************************Macro End Section**********************************/
+
+/******************************Start Data Type Section***********************/
+
+/* Called when a handler starts, may use the NVIC / SCB drivers (e.g. pend another interrupt) */
+typedef void (*NVICSIM_Handler_Type)(IRQn_Type IRQn);
+
+/* One recorded interrupt request */
+typedef struct {
+	u64 Time;							// Cycle the request is raised
+	IRQn_Type IRQn;
+} NVICSIM_Event_Type;
+
+typedef struct {
+	u32 Count;							// Handler executions
+	u32 Preemptions;					// Times this handler pre-empted another one
+	u32 TailChains;						// Times it was entered by tail-chaining
+	u64 TotalLatency;					// Sum of request -> handler start
+	u64 MaxLatency;						// Worst request -> handler start
+	u64 MaxResponse;					// Worst request -> handler end
+} NVICSIM_Stats_Type;
+
+/******************************End Data Type Section***********************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Reset
+ *  details		Puts the register model in its reset state and clears time, handlers and statistics
+ */
+void NVICSIM_Reset(void);
+
+/**
+ *  brief 	 	Sync
+ *  details		Applies what the drivers wrote to the register model (ISER/ICER, ISPR/ICPR, STIR,
+ *  			AIRCR) and refreshes the read values. A later store to the same register replaces
+ *  			the earlier one, so call it after every driver call that writes these registers
+ *  			(the simulator does so after each handler hook).
+ */
+void NVICSIM_Sync(void);
+
+/**
+ *  brief 	 	Set Handler
+ *  details		Execution time and optional start hook of an interrupt
+ *  param [in]	IRQn        Device interrupt
+ *  param [in]	ExecCycles  Handler body duration
+ *  param [in]	Hook        Called at handler start, may be NULL
+ */
+void NVICSIM_SetHandler(IRQn_Type IRQn, u32 ExecCycles, NVICSIM_Handler_Type Hook);
+
+/**
+ *  brief 	 	Run
+ *  details		Replays a trace (sorted by time) until every request was handled or stays blocked
+ *  			(disabled interrupt). Statistics accumulate over calls.
+ *  param [in]	Trace   Requests
+ *  param [in]	Events  Number of requests
+ *  return		Cycle at which the last handler finished
+ */
+u64 NVICSIM_Run(const NVICSIM_Event_Type * Trace, u32 Events);
+
+/**
+ *  brief 	 	Get Stats
+ *  param [in]	IRQn   Device interrupt
+ *  param [out]	Stats  Receives the statistics
+ *  return		OK / ERROR (invalid IRQn)
+ */
+States_Type NVICSIM_GetStats(IRQn_Type IRQn, NVICSIM_Stats_Type * Stats);
+
+/**
+ *  brief 	 	Group Priority
+ *  details		Pre-emption priority of an interrupt with the PRIGROUP in the model
+ *  param [in]	IRQn   Device interrupt
+ *  return		Group priority (lower pre-empts higher)
+ */
+u32 NVICSIM_GroupPriority(IRQn_Type IRQn);
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* NVIC_SIM_H_ */
@@ -0,0 +1,148 @@
+/**
+ ******************************************************************************
+ * @file           : OS_Sched_Bench.c
+ * @author         : Ahmed Khaled
+ * @brief          : Kernel Scheduler Host Benchmark
+ ******************************************************************************
+ *
+ * Times the scheduling paths of the real OS driver on the host: the bitmap
+ * lookup, OS_Yield between two tasks of one priority and OS_Tick with all task
+ * slots used (half of them delayed). PendSV is replaced as in OS_Sched_Test.c.
+ * Host numbers compare revisions of the kernel, they are not target cycles
+ * (OS_SWITCH_PROFILE measures those on the target).
+ *
+ * Build (include paths as for the target: OS/, NVIC/, SCB/, SysTick/, Libraries/):
+ *   gcc -std=c99 -O2 -DCORE_SIMULATION -I<include root> -I../NVIC_Sim OS_Sched_Bench.c \
+ *       ../NVIC_Sim/NVIC_Sim.c Cortex_M3_OS.c Cortex_M3_NVIC.c Cortex_M3_SCB.c -o os_sched_bench
+ *
+ * Usage: os_sched_bench [iterations]      (default 10000000)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "NVIC_Sim.h"
+#include "OS/Cortex_M3_OS.h"
+
+
+#define BENCH_TASKS				(OS_MAX_TASKS - 1U)
+#define BENCH_STACK_WORDS		32U
+
+
+extern OS_Task_Type * volatile OS_CurrentTask;
+extern OS_Task_Type * volatile OS_NextTask;
+
+static OS_Task_Type BENCH_Tasks[BENCH_TASKS];
+static u32 BENCH_u32Stacks[BENCH_TASKS][BENCH_STACK_WORDS];
+static volatile u32 BENCH_u32Sink;
+
+
+void SysTick_Init(void)
+{
+}
+
+void SysTick_SetTickHook(void (*Hook)(void))
+{
+	(void)Hook;
+}
+
+
+static double BENCH_Now(void)
+{
+	struct timespec Time;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (double)Time.tv_sec + (double)Time.tv_nsec * 1e-9;
+}
+
+
+static void BENCH_TaskBody(void * Arg)
+{
+	(void)Arg;
+}
+
+
+static void BENCH_Switch(void)
+{
+	if((SCB_SimRegisters.ICSR & (1UL << SCB_ICSR_PENDSVSET_POS)) != 0)
+	{
+		SCB_SimRegisters.ICSR = 0;
+		OS_CurrentTask = OS_NextTask;
+	}
+}
+
+
+static void BENCH_Setup(u32 Tasks, u8 Priority)
+{
+	u32 Index;
+
+	NVICSIM_Reset();
+	OS_Init();
+	for(Index = 0; Index < Tasks; Index++)
+	{
+		(void)OS_CreateTask(&BENCH_Tasks[Index], BENCH_TaskBody, NULL, BENCH_u32Stacks[Index],
+							BENCH_STACK_WORDS, Priority);
+		if(Index == 0)
+		{
+			OS_CurrentTask = &BENCH_Tasks[0];
+		}
+		BENCH_Switch();
+	}
+}
+
+
+int main(int argc, char * argv[])
+{
+	unsigned long Iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 10000000UL;
+	unsigned long Iteration;
+	u32 Index;
+	double Start;
+	double Time;
+
+	if(Iterations == 0)
+	{
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return 2;
+	}
+
+	BENCH_Setup(BENCH_TASKS, 3);
+	Start = BENCH_Now();
+	for(Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		BENCH_u32Sink += OS_HighestReadyPriority();
+	}
+	Time = BENCH_Now() - Start;
+	printf("highest ready priority  %8.2f ns\n", Time * 1e9 / (double)Iterations);
+
+	BENCH_Setup(2, 3);
+	Start = BENCH_Now();
+	for(Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		OS_Yield();
+		BENCH_Switch();
+	}
+	Time = BENCH_Now() - Start;
+	printf("yield + switch          %8.2f ns\n", Time * 1e9 / (double)Iterations);
+
+	/* Every other task delayed for longer than the run, the others share the time slice */
+	BENCH_Setup(BENCH_TASKS, 3);
+	for(Index = 0; Index < BENCH_TASKS; Index += 2U)
+	{
+		OS_CurrentTask = &BENCH_Tasks[Index];
+		OS_Delay(0XFFFFFFFFUL);
+		BENCH_Switch();
+	}
+	Start = BENCH_Now();
+	for(Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		OS_Tick();
+		BENCH_Switch();
+	}
+	Time = BENCH_Now() - Start;
+	printf("tick + switch (%lu tasks) %8.2f ns\n", (unsigned long)OS_MAX_TASKS, Time * 1e9 / (double)Iterations);
+
+	return 0;
+}
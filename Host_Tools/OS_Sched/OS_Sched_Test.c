@@ -0,0 +1,283 @@
+/**
+ ******************************************************************************
+ * @file           : OS_Sched_Test.c
+ * @author         : Ahmed Khaled
+ * @brief          : Kernel Scheduler Host Test
+ ******************************************************************************
+ *
+ * Runs the scheduling part of the real OS driver on Linux: the ready bitmap,
+ * the per-priority ready queues, delays, time slice and yield. PendSV is
+ * replaced by SCHED_Switch, which takes OS_NextTask when the kernel set
+ * PENDSVSET in the simulated ICSR; no task body ever executes.
+ *
+ * A fixed scenario is checked first, then a random sequence of ticks, yields
+ * and delays is compared against a reference model after every step.
+ *
+ * Build (include paths as for the target: OS/, NVIC/, SCB/, SysTick/, Libraries/):
+ *   gcc -std=c99 -O2 -DCORE_SIMULATION -I<include root> -I.. -I../NVIC_Sim OS_Sched_Test.c \
+ *       ../NVIC_Sim/NVIC_Sim.c Cortex_M3_OS.c Cortex_M3_NVIC.c Cortex_M3_SCB.c -o os_sched_test
+ *
+ * Usage: os_sched_test [steps] [seed]      (default 200000 1)
+ * Exit status: 0 every check passed, 1 otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "NVIC_Sim.h"
+#include "OS/Cortex_M3_OS.h"
+#include "Host_Test.h"
+
+
+#define TEST_TASKS				(OS_MAX_TASKS - 1U)				/*All but the idle task*/
+#define TEST_STACK_WORDS		32U
+
+
+extern OS_Task_Type * volatile OS_CurrentTask;
+extern OS_Task_Type * volatile OS_NextTask;
+
+static OS_Task_Type TEST_Tasks[TEST_TASKS + 1U];
+static u32 TEST_u32Stacks[TEST_TASKS + 1U][TEST_STACK_WORDS];
+
+/* Reference model: tick at which a delayed task must be ready again */
+static u32 TEST_u32WakeTick[TEST_TASKS];
+
+
+/* OS_Start is not run on the host, the SysTick driver is not linked */
+void SysTick_Init(void)
+{
+}
+
+void SysTick_SetTickHook(void (*Hook)(void))
+{
+	(void)Hook;
+}
+
+
+static void TEST_TaskBody(void * Arg)
+{
+	(void)Arg;
+}
+
+
+/* Stands in for PendSV_Handler */
+static void SCHED_Switch(void)
+{
+	if((SCB_SimRegisters.ICSR & (1UL << SCB_ICSR_PENDSVSET_POS)) != 0)
+	{
+		SCB_SimRegisters.ICSR = 0;
+		if(OS_NextTask == NULL)
+		{
+			/* Bitmap and queues disagree, nothing sensible can be checked after that */
+			printf("FAIL: switch to an empty ready queue\n");
+			exit(1);
+		}
+		OS_CurrentTask = OS_NextTask;
+	}
+}
+
+
+static States_Type TEST_Create(u32 Index, u8 Priority)
+{
+	States_Type State = OS_CreateTask(&TEST_Tasks[Index], TEST_TaskBody, NULL,
+									  TEST_u32Stacks[Index], TEST_STACK_WORDS, Priority);
+	SCHED_Switch();
+	return State;
+}
+
+
+/* OS_Init, then the first task runs as OS_Start would have picked it */
+static void TEST_Start(u8 Priority)
+{
+	NVICSIM_Reset();
+	OS_Init();
+	(void)TEST_Create(0, Priority);
+	OS_CurrentTask = &TEST_Tasks[0];
+}
+
+
+static void TEST_Scenario(void)
+{
+	OS_Task_Type * A = &TEST_Tasks[0];
+	OS_Task_Type * B = &TEST_Tasks[1];
+	OS_Task_Type * C = &TEST_Tasks[2];
+	OS_Task_Type * E = &TEST_Tasks[3];
+	u32 Index;
+
+	NVICSIM_Reset();
+	OS_Init();
+	TEST_CHECK(OS_HighestReadyPriority() == OS_IDLE_PRIORITY);
+
+	TEST_Start(2);
+	TEST_CHECK(TEST_Create(1, 2) == OK);
+	TEST_CHECK(TEST_Create(2, 5) == OK);
+	TEST_CHECK(OS_HighestReadyPriority() == 2U);
+	TEST_CHECK(OS_CurrentTask == A);
+
+	/* Round robin inside priority 2, by yield and by time slice */
+	OS_Yield();
+	SCHED_Switch();
+	TEST_CHECK(OS_CurrentTask == B);
+	OS_Yield();
+	SCHED_Switch();
+	TEST_CHECK(OS_CurrentTask == A);
+	OS_Tick();
+	SCHED_Switch();
+	TEST_CHECK(OS_CurrentTask == B);
+
+	/* Priority 2 empties, the bitmap falls back to priority 5 */
+	OS_Delay(2);
+	SCHED_Switch();
+	TEST_CHECK(OS_CurrentTask == A);
+	OS_Delay(1);
+	SCHED_Switch();
+	TEST_CHECK(OS_CurrentTask == C);
+	TEST_CHECK(OS_HighestReadyPriority() == 5U);
+
+	/* A wakes first and pre-empts C, B joins the end of the queue one tick later */
+	OS_Tick();
+	SCHED_Switch();
+	TEST_CHECK((OS_CurrentTask == A) && (B->State == OS_TASK_DELAYED));
+	OS_Tick();
+	SCHED_Switch();
+	TEST_CHECK((OS_CurrentTask == B) && (A->State == OS_TASK_READY));
+
+	/* Everything delayed: the idle task runs */
+	OS_Delay(10);
+	SCHED_Switch();
+	OS_Delay(10);
+	SCHED_Switch();
+	OS_Delay(10);
+	SCHED_Switch();
+	TEST_CHECK(OS_HighestReadyPriority() == OS_IDLE_PRIORITY);
+	TEST_CHECK(OS_CurrentTask->Priority == OS_IDLE_PRIORITY);
+
+	/* A task created while idle pre-empts it */
+	TEST_CHECK(TEST_Create(3, 1) == OK);
+	TEST_CHECK(OS_CurrentTask == E);
+
+	/* Argument checks and the task limit (idle + 4 tasks exist) */
+	TEST_CHECK(OS_CreateTask(&TEST_Tasks[4], TEST_TaskBody, NULL, TEST_u32Stacks[4],
+							 TEST_STACK_WORDS, OS_IDLE_PRIORITY) == ERROR);
+	TEST_CHECK(OS_CreateTask(&TEST_Tasks[4], TEST_TaskBody, NULL, TEST_u32Stacks[4],
+							 TEST_STACK_WORDS, OS_PRIORITIES) == ERROR);
+	TEST_CHECK(OS_CreateTask(&TEST_Tasks[4], TEST_TaskBody, NULL, TEST_u32Stacks[4],
+							 OS_STACK_FRAME_WORDS, 3) == ERROR);
+	for(Index = 4; Index < TEST_TASKS; Index++)
+	{
+		TEST_CHECK(TEST_Create(Index, 3) == OK);
+	}
+	TEST_CHECK(TEST_Create(TEST_TASKS, 3) == ERROR);
+}
+
+
+/* Most urgent ready priority according to the task states */
+static u32 TEST_ReferenceHighest(void)
+{
+	u32 Highest = OS_IDLE_PRIORITY;
+	u32 Index;
+
+	for(Index = 0; Index < TEST_TASKS; Index++)
+	{
+		if((TEST_Tasks[Index].State == OS_TASK_READY) && (TEST_Tasks[Index].Priority < Highest))
+		{
+			Highest = TEST_Tasks[Index].Priority;
+		}
+	}
+	return Highest;
+}
+
+
+static u32 TEST_ReadyAt(u32 Priority)
+{
+	u32 Count = 0;
+	u32 Index;
+
+	for(Index = 0; Index < TEST_TASKS; Index++)
+	{
+		if((TEST_Tasks[Index].State == OS_TASK_READY) && (TEST_Tasks[Index].Priority == Priority))
+		{
+			Count++;
+		}
+	}
+	return Count;
+}
+
+
+static void TEST_Random(unsigned long Steps)
+{
+	OS_Task_Type * Previous;
+	unsigned long Step;
+	u32 Index;
+	u32 Ticks;
+	u32 Highest;
+
+	/* Few priorities, so that the queues hold several tasks */
+	TEST_Start((u8)(rand() % 4));
+	for(Index = 1; Index < TEST_TASKS; Index++)
+	{
+		TEST_CHECK(TEST_Create(Index, (u8)(rand() % 4)) == OK);
+	}
+
+	for(Step = 0; Step < Steps; Step++)
+	{
+		Previous = OS_CurrentTask;
+		switch(rand() % 4)
+		{
+			case 0:
+			case 1:
+				OS_Tick();
+				break;
+
+			case 2:
+				OS_Yield();
+				SCHED_Switch();
+				/* Another ready task of the same (most urgent) priority must get the CPU */
+				if(TEST_ReadyAt(Previous->Priority) > 1U)
+				{
+					TEST_CHECK(OS_CurrentTask != Previous);
+				}
+				break;
+
+			default:
+				if(Previous->Priority != OS_IDLE_PRIORITY)
+				{
+					Ticks = 1U + (u32)(rand() % 6);
+					TEST_u32WakeTick[Previous - TEST_Tasks] = OS_GetTicks() + Ticks;
+					OS_Delay(Ticks);
+				}
+				break;
+		}
+		SCHED_Switch();
+
+		Ticks = OS_GetTicks();
+		for(Index = 0; Index < TEST_TASKS; Index++)
+		{
+			TEST_CHECK((TEST_Tasks[Index].State == OS_TASK_DELAYED) ==
+					   (Ticks < TEST_u32WakeTick[Index]));
+		}
+
+		Highest = TEST_ReferenceHighest();
+		TEST_CHECK(OS_HighestReadyPriority() == Highest);
+		TEST_CHECK((OS_CurrentTask->Priority == Highest) && (OS_CurrentTask->State == OS_TASK_READY));
+	}
+}
+
+
+int main(int argc, char * argv[])
+{
+	unsigned long Steps = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000UL;
+	unsigned int Seed   = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : 1U;
+
+	srand(Seed);
+	TEST_Scenario();
+	TEST_Random(Steps);
+
+	if(TEST_u32Failures != 0)
+	{
+		printf("%lu check(s) failed\n", (unsigned long)TEST_u32Failures);
+		return 1;
+	}
+	printf("all scheduler checks passed (%lu random steps, seed %u)\n", Steps, Seed);
+	return 0;
+}
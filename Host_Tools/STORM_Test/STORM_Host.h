@@ -0,0 +1,40 @@
+/**
+ ******************************************************************************
+ * @file           : STORM_Host.h
+ * @author         : Ahmed Khaled
+ * @brief          : Storm Limiter Host Configuration
+ ******************************************************************************
+ *
+ * Forced into every translation unit of the host test (gcc -include), so the
+ * STORM driver masks and unmasks the simulated source of STORM_Test.c instead
+ * of the NVIC.
+ */
+
+#ifndef STORM_HOST_H_
+#define STORM_HOST_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+/***************************************End Include Section*****************/
+
+/********************************************Config Section Start********************************/
+
+#define STORM_DISABLE(IRQn)					STORMSIM_SetMasked((s32)(IRQn), 1)
+#define STORM_ENABLE(IRQn)					STORMSIM_SetMasked((s32)(IRQn), 0)
+
+/********************************************Config Section End**********************************/
+
+/***********************************Software Interface Section Start*****************************/
+
+/**
+ *  brief 	 	Set Masked
+ *  details		Mask state change of a simulated interrupt source (defined by the test)
+ *  param [in]	IRQn    Interrupt
+ *  param [in]	Masked  1 masked, 0 enabled
+ */
+
+void STORMSIM_SetMasked(s32 IRQn, u8 Masked);
+
+/***********************************Software Interface End Start*****************************/
+
+#endif /* STORM_HOST_H_ */
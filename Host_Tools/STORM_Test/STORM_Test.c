@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ * @file           : STORM_Test.c
+ * @author         : Ahmed Khaled
+ * @brief          : Storm Limiter Host Test
+ ******************************************************************************
+ *
+ * Drives the real STORM driver with a simulated interrupt source on Linux.
+ * Every time unit the loop first runs STORM_Task, then delivers the
+ * interrupts of the source unless the driver masked it (STORM_DISABLE /
+ * STORM_ENABLE are redirected by STORM_Host.h). Checked: traffic at the
+ * threshold is never masked, the interrupt above it is, repeated storms
+ * double the backoff up to MaxBackoff, and a quiet source is released and
+ * starts again from the base backoff.
+ *
+ * Build (include paths as for the target: STORM/, NVIC/, Libraries/):
+ *   gcc -std=c99 -DCORE_SIMULATION -I<include root> -I.. -include STORM_Host.h \
+ *       STORM_Test.c Cortex_M3_STORM.c -o storm_test
+ *
+ * Exit status: 0 every check passed, 1 otherwise.
+ */
+
+#include <stdio.h>
+
+#include "STORM/Cortex_M3_STORM.h"
+#include "Host_Test.h"
+
+
+#define TEST_IRQn				((IRQn_Type)23)
+#define TEST_OTHER_IRQn			((IRQn_Type)40)
+#define TEST_MAX_MASKS			32U
+
+
+/* Simulated source */
+static u8  SIM_u8Masked = 0;
+static u32 SIM_u32Now = 0;
+static u32 SIM_u32Delivered = 0;
+static u32 SIM_u32Refused = 0;
+
+/* Mask / unmask times seen through STORM_DISABLE / STORM_ENABLE */
+static u32 SIM_u32MaskedAt[TEST_MAX_MASKS];
+static u32 SIM_u32ReleasedAt[TEST_MAX_MASKS];
+static u32 SIM_u32Masks = 0;
+static u32 SIM_u32Releases = 0;
+
+static const STORM_Policy_Type TEST_Policy = {
+	.Threshold  = 10,
+	.Window     = 10,
+	.Backoff    = 20,
+	.MaxBackoff = 80,
+};
+
+
+void STORMSIM_SetMasked(s32 IRQn, u8 Masked)
+{
+	TEST_CHECK(IRQn == (s32)TEST_IRQn);
+	TEST_CHECK(Masked != SIM_u8Masked);
+
+	SIM_u8Masked = Masked;
+	if(Masked == 1)
+	{
+		if(SIM_u32Masks < TEST_MAX_MASKS)
+		{
+			SIM_u32MaskedAt[SIM_u32Masks] = SIM_u32Now;
+		}
+		SIM_u32Masks++;
+	}
+	else
+	{
+		if(SIM_u32Releases < TEST_MAX_MASKS)
+		{
+			SIM_u32ReleasedAt[SIM_u32Releases] = SIM_u32Now;
+		}
+		SIM_u32Releases++;
+	}
+}
+
+
+/*
+ * Runs the driver loop for Duration time units. The source raises PerUnit interrupts in
+ * every time unit that is a multiple of Period; a masked source raises nothing.
+ */
+static void SIM_Run(u32 Duration, u32 PerUnit, u32 Period)
+{
+	u32 End = SIM_u32Now + Duration;
+	u32 Index;
+
+	for(; SIM_u32Now != End; SIM_u32Now++)
+	{
+		STORM_Task(SIM_u32Now);
+
+		if((SIM_u32Now % Period) != 0)
+		{
+			continue;
+		}
+		for(Index = 0; (Index < PerUnit) && (SIM_u8Masked == 0); Index++)
+		{
+			if(STORM_OnInterrupt(TEST_IRQn, SIM_u32Now) == OK)
+			{
+				SIM_u32Delivered++;
+			}
+			else
+			{
+				SIM_u32Refused++;
+				TEST_CHECK(SIM_u8Masked == 1);
+			}
+		}
+	}
+}
+
+
+static void TEST_Register(void)
+{
+	STORM_Policy_Type Policy = TEST_Policy;
+
+	TEST_CHECK(STORM_OnInterrupt(TEST_OTHER_IRQn, 0) == OK);
+	TEST_CHECK(STORM_Register((IRQn_Type)-1, &Policy) == ERROR);
+	TEST_CHECK(STORM_Register((IRQn_Type)60, &Policy) == ERROR);
+	TEST_CHECK(STORM_Register(TEST_IRQn, NULL) == ERROR);
+	Policy.Threshold = 0;
+	TEST_CHECK(STORM_Register(TEST_IRQn, &Policy) == ERROR);
+	TEST_CHECK(STORM_Register(TEST_IRQn, &TEST_Policy) == OK);
+}
+
+
+/* Exactly Threshold interrupts per window, for a long time: never masked */
+static void TEST_AtThreshold(void)
+{
+	STORM_Stats_Type Stats;
+
+	SIM_Run(1000, 1, 1);
+
+	TEST_CHECK(SIM_u32Masks == 0);
+	TEST_CHECK(SIM_u32Delivered == 1000U);
+	TEST_CHECK(STORM_GetStats(TEST_IRQn, &Stats) == OK);
+	TEST_CHECK((Stats.Storms == 0) && (Stats.Masked == 0) && (Stats.Interrupts == 1000U));
+	TEST_CHECK(Stats.MaxPerWindow == TEST_Policy.Threshold);
+}
+
+
+/* One interrupt above the threshold masks, a continuing storm doubles the backoff */
+static void TEST_StormAndBackoff(void)
+{
+	STORM_Stats_Type Stats;
+	u32 Expected = TEST_Policy.Backoff;
+	u32 Index;
+
+	STORM_ResetStats();
+	SIM_u32Delivered = 0;
+
+	/* Eleven interrupts in one time unit: the eleventh is refused */
+	SIM_Run(1, 11, 1);
+	TEST_CHECK((SIM_u32Masks == 1U) && (SIM_u32Delivered == 10U) && (SIM_u32Refused == 1U));
+
+	/* The storm goes on: masked 20, 40, 80, 80 ... each release storms again at once */
+	SIM_Run(20 + 40 + 80 + 80 + 10, 11, 1);
+	TEST_CHECK(SIM_u32Masks == 5U);
+	TEST_CHECK(SIM_u32Releases == 4U);
+	for(Index = 0; Index < SIM_u32Releases; Index++)
+	{
+		TEST_CHECK(SIM_u32ReleasedAt[Index] - SIM_u32MaskedAt[Index] == Expected);
+		if(Index + 1U < SIM_u32Masks)
+		{
+			/* Released sources start a new window: the storm is refused in the same unit */
+			TEST_CHECK(SIM_u32MaskedAt[Index + 1U] == SIM_u32ReleasedAt[Index]);
+		}
+		Expected = (Expected * 2U > TEST_Policy.MaxBackoff) ? TEST_Policy.MaxBackoff : Expected * 2U;
+	}
+
+	TEST_CHECK(STORM_GetStats(TEST_IRQn, &Stats) == OK);
+	TEST_CHECK((Stats.Storms == 5U) && (Stats.Masked == 1U) && (Stats.CurrentBackoff == TEST_Policy.MaxBackoff));
+	TEST_CHECK(Stats.MaskedTime == 20U + 40U + 80U + 80U);
+}
+
+
+/* The storm ends: the source is released once and later storms start from Backoff again */
+static void TEST_Release(void)
+{
+	STORM_Stats_Type Stats;
+	u32 Masks;
+
+	/* Quiet traffic, longer than MaxBackoff plus a window */
+	SIM_Run(TEST_Policy.MaxBackoff + 2U * TEST_Policy.Window, 1, 2);
+	TEST_CHECK(SIM_u32Releases == SIM_u32Masks);
+	TEST_CHECK(SIM_u8Masked == 0);
+	TEST_CHECK(STORM_GetStats(TEST_IRQn, &Stats) == OK);
+	TEST_CHECK(Stats.Masked == 0);
+
+	/* One burst after the quiet time: base backoff, not the doubled one of the last storm */
+	Masks = SIM_u32Masks;
+	SIM_Run(1, 11, 1);
+	SIM_Run(TEST_Policy.Backoff, 1, 2);
+	TEST_CHECK(SIM_u32Masks == Masks + 1U);
+	TEST_CHECK(SIM_u32Releases == Masks + 1U);
+	TEST_CHECK(SIM_u32ReleasedAt[Masks] - SIM_u32MaskedAt[Masks] == TEST_Policy.Backoff);
+}
+
+
+int main(void)
+{
+	TEST_Register();
+	TEST_AtThreshold();
+	TEST_StormAndBackoff();
+	TEST_Release();
+
+	if(TEST_u32Failures != 0)
+	{
+		printf("%lu check(s) failed\n", (unsigned long)TEST_u32Failures);
+		return 1;
+	}
+	printf("all STORM checks passed\n");
+	return 0;
+}
@@ -0,0 +1,45 @@
+
+#ifndef BIT_BAND_H_
+#define BIT_BAND_H_
+
+#include "Libraries/STD_TYPES.h"
+
+/*
+ * Cortex-M3 bit-band regions: every bit of the first 1 MB of SRAM and of the
+ * peripheral region has its own 32-bit word in an alias region, so a single
+ * store sets or clears one bit atomically (no read-modify-write).
+ *
+ * alias address = alias base + (byte offset x 32) + (bit number x 4)
+ */
+
+#define BITBAND_SRAM_BASE       0x20000000UL
+#define BITBAND_SRAM_ALIAS      0x22000000UL
+#define BITBAND_PERI_BASE       0x40000000UL
+#define BITBAND_PERI_ALIAS      0x42000000UL
+
+
+#define BITBAND_SRAM_ADDR(ADDR,BIT_NO)  (BITBAND_SRAM_ALIAS + ((((u32)(ADDR)) - BITBAND_SRAM_BASE) << 5) + (((u32)(BIT_NO)) << 2))
+
+#define BITBAND_PERI_ADDR(ADDR,BIT_NO)  (BITBAND_PERI_ALIAS + ((((u32)(ADDR)) - BITBAND_PERI_BASE) << 5) + (((u32)(BIT_NO)) << 2))
+
+#define BITBAND_SRAM(ADDR,BIT_NO)       (*((volatile u32 *) BITBAND_SRAM_ADDR(ADDR,BIT_NO)))
+
+#define BITBAND_PERI(ADDR,BIT_NO)       (*((volatile u32 *) BITBAND_PERI_ADDR(ADDR,BIT_NO)))
+
+
+/* Atomic single-store bit operations on a peripheral register (e.g. BB_SET_BIT(RCC->APB2ENR, 2)) */
+
+#define BB_SET_BIT(VAR,BIT_NO)          (BITBAND_PERI(&(VAR),BIT_NO) = 1)
+
+#define BB_CLR_BIT(VAR,BIT_NO)          (BITBAND_PERI(&(VAR),BIT_NO) = 0)
+
+#define BB_GET_BIT(VAR,BIT_NO)          (BITBAND_PERI(&(VAR),BIT_NO))
+
+
+/* Compile time check of the address computation against the reference manual (RM0008) examples */
+typedef char BITBAND_SRAM_CHECK[(BITBAND_SRAM_ADDR(0x20000300UL,2) == 0x22006008UL) ? 1 : -1];
+typedef char BITBAND_PERI_CHECK[(BITBAND_PERI_ADDR(0x40000000UL,7) == 0x4200001CUL) ? 1 : -1];
+
+
+
+#endif
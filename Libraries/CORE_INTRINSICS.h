@@ -0,0 +1,193 @@
+
+#ifndef CORE_INTRINSICS_H_
+#define CORE_INTRINSICS_H_
+
+#include "Libraries/STD_TYPES.h"
+
+/*
+ * Cortex-M3 instructions that C can not express.
+ * On a non-ARM (host) build plain C equivalents are used, they are not atomic
+ * but let the surrounding logic be compiled and tested on a PC.
+ */
+
+#if defined(__arm__)
+
+/* Load a byte and mark the address for exclusive access */
+static inline u8 CORE_LDREXB(volatile u8 * Address)
+{
+	u32 Result;
+	__asm volatile ("ldrexb %0, [%1]" : "=r" (Result) : "r" (Address) : "memory");
+	return (u8)Result;
+}
+
+/* Store a byte if the exclusive access still holds, returns 0 on success and 1 on failure */
+static inline u32 CORE_STREXB(u8 Value, volatile u8 * Address)
+{
+	u32 Result;
+	__asm volatile ("strexb %0, %2, [%1]" : "=&r" (Result) : "r" (Address), "r" ((u32)Value) : "memory");
+	return Result;
+}
+
+/* Drop the exclusive access */
+static inline void CORE_CLREX(void)
+{
+	__asm volatile ("clrex" ::: "memory");
+}
+
+/* Data memory barrier */
+static inline void CORE_DMB(void)
+{
+	__asm volatile ("dmb" ::: "memory");
+}
+
+/* Data synchronization barrier */
+static inline void CORE_DSB(void)
+{
+	__asm volatile ("dsb" ::: "memory");
+}
+
+/* Instruction synchronization barrier */
+static inline void CORE_ISB(void)
+{
+	__asm volatile ("isb" ::: "memory");
+}
+
+/* Read the BASEPRI register */
+static inline u32 CORE_GET_BASEPRI(void)
+{
+	u32 Result;
+	__asm volatile ("mrs %0, basepri" : "=r" (Result));
+	return Result;
+}
+
+/* Write the BASEPRI register (0 removes the mask) */
+static inline void CORE_SET_BASEPRI(u32 Value)
+{
+	__asm volatile ("msr basepri, %0" : : "r" (Value) : "memory");
+}
+
+/* Write BASEPRI only if it raises the mask (BASEPRI_MAX) */
+static inline void CORE_SET_BASEPRI_MAX(u32 Value)
+{
+	__asm volatile ("msr basepri_max, %0" : : "r" (Value) : "memory");
+}
+
+/* Mask / unmask every configurable interrupt (PRIMASK), a pending interrupt still ends WFI */
+static inline void CORE_DISABLE_IRQ(void)
+{
+	__asm volatile ("cpsid i" ::: "memory");
+}
+
+static inline void CORE_ENABLE_IRQ(void)
+{
+	__asm volatile ("cpsie i" ::: "memory");
+}
+
+/* Sleep until an interrupt / an event, signal an event */
+static inline void CORE_WFI(void)
+{
+	__asm volatile ("wfi" ::: "memory");
+}
+
+static inline void CORE_WFE(void)
+{
+	__asm volatile ("wfe" ::: "memory");
+}
+
+static inline void CORE_SEV(void)
+{
+	__asm volatile ("sev" ::: "memory");
+}
+
+/* Count leading zeros, returns 32 for 0 */
+static inline u32 CORE_CLZ(u32 Value)
+{
+	u32 Result;
+	__asm volatile ("clz %0, %1" : "=r" (Result) : "r" (Value));
+	return Result;
+}
+
+#else
+
+static u32 CORE_u32BasePri = 0;
+
+static inline u8 CORE_LDREXB(volatile u8 * Address)
+{
+	return *Address;
+}
+
+static inline u32 CORE_STREXB(u8 Value, volatile u8 * Address)
+{
+	*Address = Value;
+	return 0;
+}
+
+static inline void CORE_CLREX(void)
+{
+}
+
+static inline void CORE_DMB(void)
+{
+	__sync_synchronize();
+}
+
+static inline void CORE_DSB(void)
+{
+	__sync_synchronize();
+}
+
+static inline void CORE_ISB(void)
+{
+	__sync_synchronize();
+}
+
+static inline u32 CORE_GET_BASEPRI(void)
+{
+	return CORE_u32BasePri;
+}
+
+static inline void CORE_SET_BASEPRI(u32 Value)
+{
+	CORE_u32BasePri = Value & 0XFFUL;
+}
+
+static inline void CORE_SET_BASEPRI_MAX(u32 Value)
+{
+	Value &= 0XFFUL;
+	if((Value != 0) && ((CORE_u32BasePri == 0) || (Value < CORE_u32BasePri)))
+	{
+		CORE_u32BasePri = Value;
+	}
+}
+
+static inline void CORE_DISABLE_IRQ(void)
+{
+}
+
+static inline void CORE_ENABLE_IRQ(void)
+{
+}
+
+/* No sleep on the host, the caller simply goes on */
+static inline void CORE_WFI(void)
+{
+}
+
+static inline void CORE_WFE(void)
+{
+}
+
+static inline void CORE_SEV(void)
+{
+}
+
+static inline u32 CORE_CLZ(u32 Value)
+{
+	return (Value == 0) ? 32UL : (u32)__builtin_clz((unsigned int)Value);
+}
+
+#endif
+
+
+
+#endif
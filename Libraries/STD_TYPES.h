@@ -11,10 +11,15 @@ typedef signed short int                s16;
 typedef unsigned long int               u32;
 typedef signed long int                 s32;
 
+typedef unsigned long long int          u64;
+typedef signed long long int            s64;
+
 typedef float                           f32;
 typedef double                          f64;
 
+#ifndef NULL
 #define NULL 0
+#endif
 
 typedef enum{
 	ERROR	=0,
@@ -5,7 +5,44 @@
  * @brief          : NVIC Source File
  ******************************************************************************/
 #include "NVIC/Cortex_M3_NVIC.h"
+#include "SCB/Cortex_M3_SCB.h"
 #include "Libraries/BIT_MATH.h"
+#include "Libraries/CORE_INTRINSICS.h"
+#if (NVIC_CRITICAL_DEBUG == 1) || (NVIC_PROFILE_ENABLE == 1)
+#include "DWT/Cortex_M3_DWT.h"
+#endif
+
+
+/* Byte of SCB->SHPR1..3 that holds the priority of a system handler (IRQn -12 .. -1) */
+#define NVIC_SHPR_BYTE(IRQn)	(((volatile u8 *) &(SCB->SHPR1))[(((u32)(IRQn)) & 0X0FUL) - 4UL])
+
+
+#if NVIC_CRITICAL_DEBUG == 1
+/* Entry time of each nested critical section and longest hold time of each section ID */
+static u32 NVIC_u32CriticalStart[NVIC_CRITICAL_MAX_DEPTH];
+static volatile u8 NVIC_u8CriticalDepth = 0;
+static u32 NVIC_u32CriticalMax[NVIC_CRITICAL_SECTIONS];
+#endif
+
+
+#if NVIC_PROFILE_ENABLE == 1
+/* Per interrupt statistics (index IRQn + 16) */
+static NVIC_Profile_Type NVIC_ProfileTable[NVIC_PROFILE_SLOTS];
+static u32 NVIC_u32PendingTime[NVIC_PROFILE_SLOTS];
+static u8  NVIC_u8PendingMarked[NVIC_PROFILE_SLOTS];
+
+/* Handlers currently running: entry time and time spent in nested handlers */
+static u32 NVIC_u32ProfileStart[NVIC_PROFILE_MAX_DEPTH];
+static u32 NVIC_u32ProfileChild[NVIC_PROFILE_MAX_DEPTH];
+static volatile u8 NVIC_u8ProfileDepth = 0;
+#endif
+
+/* NVIC_IP as 32-bit words, four interrupts per word */
+#define NVIC_IP_WORDS			((volatile u32 *) (NVIC->NVIC_IP))
+
+/* Predefined configurations and the last one applied */
+static const NVIC_Context_Type * NVIC_ContextProfiles[NVIC_CONTEXT_PROFILES];
+static u8 NVIC_u8ActiveProfile = NVIC_CONTEXT_NONE;
 
 
 
@@ -18,10 +55,11 @@
 void NVIC_EnableIRQ(IRQn_Type IRQn)
 {
 	/* Check if the provided IRQn is a valid positive value */
-	if((u32)IRQn >= 0)
+	if((s32)IRQn >= 0)
 	{
-		/* Set the specific bit in the selected NVIC_ISER register to enable the interrupt */
-		SET_BIT(NVIC->NVIC_ISER[((u32)IRQn >> 5 )],((u32)IRQn &0X1F));
+		/* Set the specific bit in the selected NVIC_ISER register to enable the interrupt.
+		 * The register is write-1-to-act: a single store, no read-modify-write. */
+		NVIC->NVIC_ISER[((u32)IRQn >> 5 )] = NVIC_IRQ_MASK(IRQn);
 	}
 
 }
@@ -38,10 +76,11 @@ void NVIC_DisableIRQ(IRQn_Type IRQn)
 {
 
 	/* Check if the provided IRQn is a valid positive value */
-	if((u32)IRQn >= 0)
+	if((s32)IRQn >= 0)
 	{
-		/* Set the specific bit in the selected NVIC_ICER register to disable the interrupt */
-		SET_BIT(NVIC->NVIC_ICER[((u32)IRQn >> 5 )],((u32)IRQn &0X1F));
+		/* Set the specific bit in the selected NVIC_ICER register to disable the interrupt.
+		 * The register is write-1-to-act: a single store, no read-modify-write. */
+		NVIC->NVIC_ICER[((u32)IRQn >> 5 )] = NVIC_IRQ_MASK(IRQn);
 	}
 
 }
@@ -57,10 +96,11 @@ void NVIC_SetPendingIRQ(IRQn_Type IRQn)
 {
 
 	/* Check if the provided IRQn is a valid positive value */
-	if((u32)IRQn >= 0)
+	if((s32)IRQn >= 0)
 	{
-		/* Set the specific bit in the selected NVIC_ISPR register to enable pending the interrupt */
-		SET_BIT(NVIC->NVIC_ISPR[((u32)IRQn >> 5 )],((u32)IRQn &0X1F));
+		/* Set the specific bit in the selected NVIC_ISPR register to enable pending the interrupt.
+		 * The register is write-1-to-act: a single store, no read-modify-write. */
+		NVIC->NVIC_ISPR[((u32)IRQn >> 5 )] = NVIC_IRQ_MASK(IRQn);
 	}
 
 }
@@ -75,10 +115,11 @@ void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
 {
 
 	/* Check if the provided IRQn is a valid positive value */
-	if((u32)IRQn >= 0)
+	if((s32)IRQn >= 0)
 	{
-		/* Set the specific bit in the selected NVIC_ICPR register to disable pending the interrupt */
-		SET_BIT(NVIC->NVIC_ICPR[((u32)IRQn >> 5 )],((u32)IRQn &0X1F));
+		/* Set the specific bit in the selected NVIC_ICPR register to disable pending the interrupt.
+		 * The register is write-1-to-act: a single store, no read-modify-write. */
+		NVIC->NVIC_ICPR[((u32)IRQn >> 5 )] = NVIC_IRQ_MASK(IRQn);
 	}
 
 }
@@ -112,16 +153,22 @@ u32 NVIC_GetActive(IRQn_Type IRQn)
 void NVIC_SetPriority(IRQn_Type IRQn, u32 Priority)
 {
 	// Check if the provided IRQn is valid
-	if((u32)IRQn >= 0)
+	if((s32)IRQn >= 0)
 	{
 		// Set priority for the specified interrupt by updating NVIC_IP register
 
-		NVIC->NVIC_IP[(u32)IRQn] = (u8)(Priority << 4)   & (u32) 0XFF;
+		NVIC->NVIC_IP[(u32)IRQn] = (u8)((Priority << (8U - NVIC_PRIO_BITS)) & (u32) 0XFF);
 
 	}
+	else if((s32)IRQn >= (s32)MemoryManagement_IRQn)
+	{
+		// System handler: its priority lives in SCB->SHPR1..3
+
+		NVIC_SHPR_BYTE(IRQn) = (u8)((Priority << (8U - NVIC_PRIO_BITS)) & (u32) 0XFF);
+	}
 	else
 	{
-		/*Nothing*/
+		/*Nothing: NMI and HardFault have a fixed priority*/
 
 	}
 }
@@ -140,11 +187,17 @@ void NVIC_SetPriority(IRQn_Type IRQn, u32 Priority)
 u32 NVIC_GetPriority(IRQn_Type IRQn)
 {
 	// Check if the provided IRQn is valid
-	if(IRQn >= 0)
+	if((s32)IRQn >= 0)
 	{
         // Retrieve and return the priority for the specified interrupt
 
-		return ((NVIC->NVIC_IP[(u32)IRQn]) >> 4);
+		return ((NVIC->NVIC_IP[(u32)IRQn]) >> (8U - NVIC_PRIO_BITS));
+	}
+	else if((s32)IRQn >= (s32)MemoryManagement_IRQn)
+	{
+		// System handler: its priority lives in SCB->SHPR1..3
+
+		return (NVIC_SHPR_BYTE(IRQn) >> (8U - NVIC_PRIO_BITS));
 	}
 	else
 	{
@@ -152,3 +205,732 @@ u32 NVIC_GetPriority(IRQn_Type IRQn)
 	}
 	return 0 ;
 }
+
+
+/**
+ *  brief 	 	Enable Interrupts (bulk)
+ *  details		Enables every interrupt selected in Mask with a single store to NVIC_ISER[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_EnableIRQMask(u32 Word, u32 Mask)
+{
+	if(Word < NVIC_REG_WORDS)
+	{
+		NVIC->NVIC_ISER[Word] = Mask;
+	}
+}
+
+
+/**
+ *  brief 	 	Disable Interrupts (bulk)
+ *  details		Disables every interrupt selected in Mask with a single store to NVIC_ICER[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_DisableIRQMask(u32 Word, u32 Mask)
+{
+	if(Word < NVIC_REG_WORDS)
+	{
+		NVIC->NVIC_ICER[Word] = Mask;
+	}
+}
+
+
+/**
+ *  brief 	 	Set Pending Interrupts (bulk)
+ *  details		Sets the pending bit of every interrupt selected in Mask with a single store to NVIC_ISPR[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_SetPendingIRQMask(u32 Word, u32 Mask)
+{
+	if(Word < NVIC_REG_WORDS)
+	{
+		NVIC->NVIC_ISPR[Word] = Mask;
+	}
+}
+
+
+/**
+ *  brief 	 	Clear Pending Interrupts (bulk)
+ *  details		Clears the pending bit of every interrupt selected in Mask with a single store to NVIC_ICPR[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_ClearPendingIRQMask(u32 Word, u32 Mask)
+{
+	if(Word < NVIC_REG_WORDS)
+	{
+		NVIC->NVIC_ICPR[Word] = Mask;
+	}
+}
+
+
+/**
+ *  brief 	 	Trigger Interrupt
+ *  details		Pends an interrupt from software through NVIC_STIR (single store)
+ *  param [in]	IRQn Device specific interrupt number
+ *  note		IRQn must not be negative
+ */
+void NVIC_TriggerIRQ(IRQn_Type IRQn)
+{
+	if((s32)IRQn >= 0)
+	{
+		NVIC->NVIC_STIR = ((u32)IRQn & 0X1FFUL);
+	}
+}
+
+
+
+/**
+ *  brief 	 	Get Pending Interrupt
+ *  details		Reads the pending register in the NVIC and returns the pending bit of a device specific interrupt
+ *  param [in]	IRQn Device specific interrupt number
+ *  return		0  Interrupt is not pending
+ *  return 		1  Interrupt is pending
+ *  note		IRQn must not be negative
+ */
+u32 NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+	if((s32)IRQn < 0)
+	{
+		return 0;
+	}
+	return GET_BIT(NVIC->NVIC_ISPR[((u32)IRQn >> 5 )],((u32)IRQn &0X1F));
+}
+
+
+/**
+ *  brief 	 	Get Enabled Mask
+ *  details		Snapshot of NVIC_ISER[Word]
+ *  param [in]	Word  Register index
+ *  return		Enabled interrupts of the word, 0 for an invalid word
+ */
+u32 NVIC_GetEnabledMask(u32 Word)
+{
+	return (Word < NVIC_REG_WORDS) ? NVIC->NVIC_ISER[Word] : 0UL;
+}
+
+
+/**
+ *  brief 	 	Get Pending Mask
+ *  details		Snapshot of NVIC_ISPR[Word]
+ *  param [in]	Word  Register index
+ *  return		Pending interrupts of the word, 0 for an invalid word
+ */
+u32 NVIC_GetPendingMask(u32 Word)
+{
+	return (Word < NVIC_REG_WORDS) ? NVIC->NVIC_ISPR[Word] : 0UL;
+}
+
+
+/**
+ *  brief 	 	Get Active Mask
+ *  details		Snapshot of NVIC_IABR[Word]
+ *  param [in]	Word  Register index
+ *  return		Active interrupts of the word, 0 for an invalid word
+ */
+u32 NVIC_GetActiveMask(u32 Word)
+{
+	return (Word < NVIC_REG_WORDS) ? NVIC->NVIC_IABR[Word] : 0UL;
+}
+
+
+/**
+ *  brief 	 	Highest Priority in Masks
+ *  details		Walks the set bits of the masks with CLZ (one iteration per set bit) and keeps the
+ *  			interrupt with the lowest NVIC_IP value, the lowest IRQn winning a tie
+ *  param [in]	Masks   NVIC_DEVICE_WORDS words, one bit per interrupt
+ *  param [out]	pIRQn   Receives the interrupt number
+ *  return		OK when at least one bit is set
+ */
+static States_Type NVIC_enuHighestInMasks(const u32 * Masks, IRQn_Type * pIRQn)
+{
+	u32 Word;
+	u32 Mask;
+	u32 Bit;
+	u32 IRQ;
+	u32 Priority;
+	u32 BestPriority = 0X100UL;		// Above any 8-bit priority
+	u32 BestIRQ = 0;
+
+	for(Word = 0; Word < NVIC_DEVICE_WORDS; Word++)
+	{
+		Mask = Masks[Word];
+		while(Mask != 0)
+		{
+			/* Highest set bit first; on equal priority the lower IRQn wins, as in the NVIC */
+			Bit      = 31UL - CORE_CLZ(Mask);
+			IRQ      = (Word << 5) + Bit;
+			Priority = NVIC->NVIC_IP[IRQ];
+			if((Priority < BestPriority) || ((Priority == BestPriority) && (IRQ < BestIRQ)))
+			{
+				BestPriority = Priority;
+				BestIRQ      = IRQ;
+			}
+			Mask &= ~(1UL << Bit);
+		}
+	}
+
+	if((BestPriority == 0X100UL) || (pIRQn == NULL))
+	{
+		return ERROR;
+	}
+	*pIRQn = (IRQn_Type)BestIRQ;
+	return OK;
+}
+
+
+/**
+ *  brief 	 	Get Highest Pending Interrupt
+ *  details		Scans the pending and enabled interrupts and returns the one the NVIC would take next
+ *  param [out]	pIRQn  Receives the interrupt number
+ *  return		OK     An enabled interrupt is pending
+ *  return		ERROR  No enabled interrupt is pending
+ */
+States_Type NVIC_GetHighestPendingIRQ(IRQn_Type * pIRQn)
+{
+	u32 Masks[NVIC_DEVICE_WORDS];
+	u32 Word;
+
+	for(Word = 0; Word < NVIC_DEVICE_WORDS; Word++)
+	{
+		/* A pending interrupt that is disabled does not block anything */
+		Masks[Word] = NVIC->NVIC_ISPR[Word] & NVIC->NVIC_ISER[Word];
+	}
+	return NVIC_enuHighestInMasks(Masks, pIRQn);
+}
+
+
+/**
+ *  brief 	 	Get Highest Active Interrupt
+ *  details		Scans the active interrupts and returns the one with the highest priority
+ *  param [out]	pIRQn  Receives the interrupt number
+ *  return		OK     A device interrupt is active
+ *  return		ERROR  No device interrupt is active
+ */
+States_Type NVIC_GetHighestActiveIRQ(IRQn_Type * pIRQn)
+{
+	u32 Masks[NVIC_DEVICE_WORDS];
+	u32 Word;
+
+	for(Word = 0; Word < NVIC_DEVICE_WORDS; Word++)
+	{
+		Masks[Word] = NVIC->NVIC_IABR[Word];
+	}
+	return NVIC_enuHighestInMasks(Masks, pIRQn);
+}
+
+
+/**
+ *  brief 	 	Encode Priority
+ *  details		Builds the priority value of NVIC_SetPriority from a pre-emption priority and a
+ *  			sub-priority for a given priority grouping
+ *  param [in]	PriorityGroup    Priority grouping (SCB_PRIORITYGROUP_0 .. SCB_PRIORITYGROUP_4)
+ *  param [in]	PreemptPriority  Pre-emption priority (extra bits are dropped)
+ *  param [in]	SubPriority      Sub-priority (extra bits are dropped)
+ *  return		Priority value for NVIC_SetPriority
+ */
+u32 NVIC_EncodePriority(u32 PriorityGroup, u32 PreemptPriority, u32 SubPriority)
+{
+	u32 PreemptBits = NVIC_PREEMPT_BITS(PriorityGroup);
+	u32 SubBits     = NVIC_SUB_BITS(PriorityGroup);
+
+	return (((PreemptPriority & ((1UL << PreemptBits) - 1UL)) << SubBits) |
+			 (SubPriority & ((1UL << SubBits) - 1UL)));
+}
+
+
+/**
+ *  brief 	 	Decode Priority
+ *  details		Splits a priority value of NVIC_GetPriority into pre-emption priority and sub-priority
+ *  param [in]	Priority         Priority value (as returned by NVIC_GetPriority)
+ *  param [in]	PriorityGroup    Priority grouping (SCB_PRIORITYGROUP_0 .. SCB_PRIORITYGROUP_4)
+ *  param [out]	pPreemptPriority Pre-emption priority
+ *  param [out]	pSubPriority     Sub-priority
+ */
+void NVIC_DecodePriority(u32 Priority, u32 PriorityGroup, u32 * pPreemptPriority, u32 * pSubPriority)
+{
+	u32 PreemptBits = NVIC_PREEMPT_BITS(PriorityGroup);
+	u32 SubBits     = NVIC_SUB_BITS(PriorityGroup);
+
+	if((pPreemptPriority != NULL) && (pSubPriority != NULL))
+	{
+		*pPreemptPriority = (Priority >> SubBits) & ((1UL << PreemptBits) - 1UL);
+		*pSubPriority     = Priority & ((1UL << SubBits) - 1UL);
+	}
+}
+
+
+/**
+ *  brief 	 	Set Grouped Priority
+ *  details		Sets the priority of an interrupt or system handler from a pre-emption priority and a
+ *  			sub-priority, checked against the active grouping (set by SCB_SetPriorityGrouping)
+ *  param [in]	IRQn             Interrupt number (system handlers MemoryManagement_IRQn .. SysTick_IRQn included)
+ *  param [in]	PreemptPriority  Pre-emption priority
+ *  param [in]	SubPriority      Sub-priority
+ *  return		OK     The priority is set
+ *  return		ERROR  A value does not fit in the bits of the active grouping, nothing is changed
+ */
+States_Type NVIC_SetGroupedPriority(IRQn_Type IRQn, u32 PreemptPriority, u32 SubPriority)
+{
+	u32 PriorityGroup = SCB_GetPriorityGrouping();
+
+	if((PreemptPriority >= (1UL << NVIC_PREEMPT_BITS(PriorityGroup))) ||
+	   (SubPriority >= (1UL << NVIC_SUB_BITS(PriorityGroup))) ||
+	   ((s32)IRQn < (s32)MemoryManagement_IRQn))
+	{
+		return ERROR;
+	}
+
+	NVIC_SetPriority(IRQn, NVIC_EncodePriority(PriorityGroup, PreemptPriority, SubPriority));
+	return OK;
+}
+
+
+/**
+ *  brief 	 	Get Grouped Priority
+ *  details		Reads the priority of an interrupt or system handler split with the active grouping
+ *  param [in]	IRQn             Interrupt number
+ *  param [out]	pPreemptPriority Pre-emption priority
+ *  param [out]	pSubPriority     Sub-priority
+ */
+void NVIC_GetGroupedPriority(IRQn_Type IRQn, u32 * pPreemptPriority, u32 * pSubPriority)
+{
+	NVIC_DecodePriority(NVIC_GetPriority(IRQn), SCB_GetPriorityGrouping(), pPreemptPriority, pSubPriority);
+}
+
+
+/**
+ *  brief 	 	Enter Critical Section
+ *  details		Masks, through BASEPRI_MAX, every interrupt whose pre-emption priority is numerically
+ *  			greater than or equal to Priority. More urgent interrupts (lower value) keep running.
+ *  param [in]	Priority   Threshold in NVIC_SetPriority units (1 .. 15)
+ *  param [in]	SectionId  Section identifier for the debug statistics
+ *  return		State to pass to NVIC_ExitCritical
+ */
+u32 NVIC_EnterCritical(u32 Priority, u8 SectionId)
+{
+	u32 State = CORE_GET_BASEPRI();
+#if NVIC_CRITICAL_DEBUG == 1
+	u8  Depth;
+#endif
+
+	/* BASEPRI = 0 means "no mask", so the most urgent level that can be masked is 1 */
+	if(Priority == 0)
+	{
+		Priority = 1;
+	}
+
+	/* BASEPRI_MAX only raises the mask: an inner, weaker section keeps the outer threshold */
+	CORE_SET_BASEPRI_MAX((Priority << (8U - NVIC_PRIO_BITS)) & 0XFFUL);
+
+#if NVIC_CRITICAL_DEBUG == 1
+	/* Claim the depth slot with its start time, as NVIC_ProfileEnter: a more urgent section reuses it */
+	do
+	{
+		Depth = CORE_LDREXB(&NVIC_u8CriticalDepth);
+		if(Depth < NVIC_CRITICAL_MAX_DEPTH)
+		{
+			NVIC_u32CriticalStart[Depth] = DWT_GET_CYCLES();
+		}
+	}while(CORE_STREXB(Depth + 1, &NVIC_u8CriticalDepth) != 0);
+#endif
+	(void)SectionId;
+
+	return State;
+}
+
+
+/**
+ *  brief 	 	Exit Critical Section
+ *  details		Restores the BASEPRI value saved by the matching NVIC_EnterCritical
+ *  param [in]	State      Value returned by NVIC_EnterCritical
+ *  param [in]	SectionId  Same identifier as given to NVIC_EnterCritical
+ */
+void NVIC_ExitCritical(u32 State, u8 SectionId)
+{
+#if NVIC_CRITICAL_DEBUG == 1
+	u32 Held;
+	u8  Depth;
+
+	if(NVIC_u8CriticalDepth > 0)
+	{
+		Depth = NVIC_u8CriticalDepth - 1;
+		if((Depth < NVIC_CRITICAL_MAX_DEPTH) && (SectionId < NVIC_CRITICAL_SECTIONS))
+		{
+			Held = DWT_GET_CYCLES() - NVIC_u32CriticalStart[Depth];
+			if(Held > NVIC_u32CriticalMax[SectionId])
+			{
+				NVIC_u32CriticalMax[SectionId] = Held;
+			}
+		}
+		/* Release the slot only once it was read */
+		NVIC_u8CriticalDepth = Depth;
+	}
+#endif
+	(void)SectionId;
+
+	CORE_SET_BASEPRI(State);
+}
+
+
+/**
+ *  brief 	 	Get Critical Section Max Time
+ *  details		Returns the longest time a section held the mask (NVIC_CRITICAL_DEBUG only)
+ *  param [in]	SectionId  Section identifier
+ *  return		Longest hold time in DWT cycles, 0 when debug mode is off
+ */
+u32 NVIC_GetCriticalMaxCycles(u8 SectionId)
+{
+#if NVIC_CRITICAL_DEBUG == 1
+	if(SectionId < NVIC_CRITICAL_SECTIONS)
+	{
+		return NVIC_u32CriticalMax[SectionId];
+	}
+#endif
+	(void)SectionId;
+	return 0;
+}
+
+
+/**
+ *  brief 	 	Reset Critical Section Statistics
+ *  details		Clears the longest hold times recorded in debug mode
+ */
+void NVIC_ResetCriticalStats(void)
+{
+#if NVIC_CRITICAL_DEBUG == 1
+	u8 Index;
+
+	for(Index = 0; Index < NVIC_CRITICAL_SECTIONS; Index++)
+	{
+		NVIC_u32CriticalMax[Index] = 0;
+	}
+#endif
+}
+
+
+#if NVIC_PROFILE_ENABLE == 1
+/**
+ *  brief 	 	Profile Mark Pending
+ *  details		Records the time an interrupt became pending, the next entry measures the latency
+ *  param [in]	IRQn  Interrupt number
+ */
+void NVIC_ProfileMarkPending(IRQn_Type IRQn)
+{
+	u32 Slot = (u32)((s32)IRQn + 16);
+
+	if(Slot < NVIC_PROFILE_SLOTS)
+	{
+		NVIC_u32PendingTime[Slot]  = DWT_GET_CYCLES();
+		NVIC_u8PendingMarked[Slot] = 1;
+	}
+}
+
+
+/**
+ *  brief 	 	Profile Enter
+ *  details		First statement of an instrumented handler (through NVIC_PROFILE_ENTER)
+ *  param [in]	IRQn  Interrupt number of the handler
+ */
+void NVIC_ProfileEnter(IRQn_Type IRQn)
+{
+	u32 Slot = (u32)((s32)IRQn + 16);
+	u32 Now;
+	u8  Depth;
+
+	/*
+	 * Claim the depth slot together with its entry time: a handler that pre-empts this loop
+	 * uses the same slot, and its exception entry / return clears the exclusive monitor, so
+	 * the slot is written again, after it, before it is claimed.
+	 */
+	do
+	{
+		Depth = CORE_LDREXB(&NVIC_u8ProfileDepth);
+		Now   = DWT_GET_CYCLES();
+		if(Depth < NVIC_PROFILE_MAX_DEPTH)
+		{
+			NVIC_u32ProfileStart[Depth] = Now;
+			NVIC_u32ProfileChild[Depth] = 0;
+		}
+	}while(CORE_STREXB(Depth + 1, &NVIC_u8ProfileDepth) != 0);
+
+	if(Slot < NVIC_PROFILE_SLOTS)
+	{
+		if((Depth + 1) > NVIC_ProfileTable[Slot].MaxNesting)
+		{
+			NVIC_ProfileTable[Slot].MaxNesting = Depth + 1;
+		}
+		if(NVIC_u8PendingMarked[Slot] == 1)
+		{
+			NVIC_u8PendingMarked[Slot] = 0;
+			if((Now - NVIC_u32PendingTime[Slot]) > NVIC_ProfileTable[Slot].MaxLatencyCycles)
+			{
+				NVIC_ProfileTable[Slot].MaxLatencyCycles = Now - NVIC_u32PendingTime[Slot];
+			}
+		}
+	}
+}
+
+
+/**
+ *  brief 	 	Profile Exit
+ *  details		Last statement of an instrumented handler (through NVIC_PROFILE_EXIT)
+ *  param [in]	IRQn  Interrupt number of the handler
+ */
+void NVIC_ProfileExit(IRQn_Type IRQn)
+{
+	u32 Now  = DWT_GET_CYCLES();
+	u32 Slot = (u32)((s32)IRQn + 16);
+	u32 Inclusive;
+	u32 Self;
+	u8  Depth;
+
+	if(NVIC_u8ProfileDepth == 0)
+	{
+		return;
+	}
+	Depth = NVIC_u8ProfileDepth - 1;
+
+	if(Depth >= NVIC_PROFILE_MAX_DEPTH)
+	{
+		NVIC_u8ProfileDepth = Depth;
+		return;
+	}
+
+	/* Own time = time since entry minus the handlers that pre-empted this one */
+	Inclusive = Now - NVIC_u32ProfileStart[Depth];
+	Self      = Inclusive - NVIC_u32ProfileChild[Depth];
+	if(Depth > 0)
+	{
+		NVIC_u32ProfileChild[Depth - 1] += Inclusive;
+	}
+
+	/* Release the slot only once it was read, a pre-empting handler reuses it */
+	NVIC_u8ProfileDepth = Depth;
+
+	if(Slot < NVIC_PROFILE_SLOTS)
+	{
+		NVIC_ProfileTable[Slot].Count++;
+		NVIC_ProfileTable[Slot].TotalCycles += Self;
+		if(Self > NVIC_ProfileTable[Slot].MaxCycles)
+		{
+			NVIC_ProfileTable[Slot].MaxCycles = Self;
+		}
+	}
+}
+
+
+/**
+ *  brief 	 	Get Profile
+ *  details		Copies the statistics of one interrupt (consistent snapshot for handlers of priority 1 .. 15)
+ *  param [in]	IRQn      Interrupt number
+ *  param [out]	Snapshot  Receives the statistics
+ */
+void NVIC_GetProfile(IRQn_Type IRQn, NVIC_Profile_Type * Snapshot)
+{
+	u32 Slot = (u32)((s32)IRQn + 16);
+	u32 State;
+
+	if((Snapshot == NULL) || (Slot >= NVIC_PROFILE_SLOTS))
+	{
+		return;
+	}
+
+	/*
+	 * Profiled handlers must not update the entry while it is copied. Bare BASEPRI mask, not
+	 * NVIC_EnterCritical: the profiler must not show up in the critical section statistics.
+	 */
+	State = CORE_GET_BASEPRI();
+	CORE_SET_BASEPRI_MAX((1UL << (8U - NVIC_PRIO_BITS)) & 0XFFUL);
+	*Snapshot = NVIC_ProfileTable[Slot];
+	CORE_SET_BASEPRI(State);
+
+	Snapshot->AverageCycles = (Snapshot->Count != 0) ? (u32)(Snapshot->TotalCycles / Snapshot->Count) : 0;
+}
+
+
+/**
+ *  brief 	 	Reset Profile
+ *  details		Clears the statistics of every interrupt
+ */
+void NVIC_ResetProfile(void)
+{
+	u32 Slot;
+	u32 State;
+
+	/* Same bare mask as NVIC_GetProfile */
+	State = CORE_GET_BASEPRI();
+	CORE_SET_BASEPRI_MAX((1UL << (8U - NVIC_PRIO_BITS)) & 0XFFUL);
+	for(Slot = 0; Slot < NVIC_PROFILE_SLOTS; Slot++)
+	{
+		NVIC_ProfileTable[Slot].Count            = 0;
+		NVIC_ProfileTable[Slot].TotalCycles      = 0;
+		NVIC_ProfileTable[Slot].MaxCycles        = 0;
+		NVIC_ProfileTable[Slot].AverageCycles    = 0;
+		NVIC_ProfileTable[Slot].MaxLatencyCycles = 0;
+		NVIC_ProfileTable[Slot].MaxNesting       = 0;
+		NVIC_u8PendingMarked[Slot]               = 0;
+	}
+	CORE_SET_BASEPRI(State);
+}
+#endif
+
+
+
+
+/**
+ *  brief 	 	Save Context
+ *  details		Snapshots the interrupt configuration with word-wide reads
+ *  param [out]	Context  Receives the configuration
+ */
+void NVIC_SaveContext(NVIC_Context_Type * Context)
+{
+	u32 Word;
+
+	if(Context == NULL)
+	{
+		return;
+	}
+
+	for(Word = 0; Word < NVIC_DEVICE_WORDS; Word++)
+	{
+		Context->Enable[Word] = NVIC->NVIC_ISER[Word];
+	}
+	for(Word = 0; Word < NVIC_DEVICE_IP_WORDS; Word++)
+	{
+		Context->Priority[Word] = NVIC_IP_WORDS[Word];
+	}
+	Context->SystemPriority[0] = SCB->SHPR1;
+	Context->SystemPriority[1] = SCB->SHPR2;
+	Context->SystemPriority[2] = SCB->SHPR3;
+	Context->PriorityGroup     = SCB_GetPriorityGrouping();
+}
+
+
+
+
+/**
+ *  brief 	 	Restore Context
+ *  details		Disables the device interrupts, writes grouping and priorities, then enables the saved set
+ *  param [in]	Context  Configuration to apply
+ */
+void NVIC_RestoreContext(const NVIC_Context_Type * Context)
+{
+	u32 Word;
+
+	if(Context == NULL)
+	{
+		return;
+	}
+
+	/* No interrupt may be taken with half of the new priorities written */
+	for(Word = 0; Word < NVIC_DEVICE_WORDS; Word++)
+	{
+		NVIC->NVIC_ICER[Word] = 0XFFFFFFFFUL;
+	}
+	CORE_DSB();
+
+	if(Context->PriorityGroup != SCB_GetPriorityGrouping())
+	{
+		SCB_SetPriorityGrouping(Context->PriorityGroup);
+	}
+	for(Word = 0; Word < NVIC_DEVICE_IP_WORDS; Word++)
+	{
+		NVIC_IP_WORDS[Word] = Context->Priority[Word];
+	}
+	SCB->SHPR1 = Context->SystemPriority[0];
+	SCB->SHPR2 = Context->SystemPriority[1];
+	SCB->SHPR3 = Context->SystemPriority[2];
+
+	for(Word = 0; Word < NVIC_DEVICE_WORDS; Word++)
+	{
+		NVIC->NVIC_ISER[Word] = Context->Enable[Word];
+	}
+	CORE_DSB();
+	CORE_ISB();
+}
+
+
+
+
+/**
+ *  brief 	 	Register Profile
+ *  param [in]	ProfileId  0 .. NVIC_CONTEXT_PROFILES-1
+ *  param [in]	Context    Configuration of the profile
+ *  return		OK / ERROR
+ */
+States_Type NVIC_RegisterProfile(u8 ProfileId, const NVIC_Context_Type * Context)
+{
+	if((ProfileId >= NVIC_CONTEXT_PROFILES) || (Context == NULL))
+	{
+		return ERROR;
+	}
+	NVIC_ContextProfiles[ProfileId] = Context;
+	return OK;
+}
+
+
+
+
+/**
+ *  brief 	 	Switch Profile
+ *  param [in]	ProfileId  0 .. NVIC_CONTEXT_PROFILES-1
+ *  return		OK / ERROR
+ */
+States_Type NVIC_SwitchProfile(u8 ProfileId)
+{
+	if((ProfileId >= NVIC_CONTEXT_PROFILES) || (NVIC_ContextProfiles[ProfileId] == NULL))
+	{
+		return ERROR;
+	}
+	NVIC_RestoreContext(NVIC_ContextProfiles[ProfileId]);
+	NVIC_u8ActiveProfile = ProfileId;
+	return OK;
+}
+
+
+
+
+/**
+ *  brief 	 	Get Active Profile
+ *  return		ID of the last profile applied, NVIC_CONTEXT_NONE if none
+ */
+u8 NVIC_GetActiveProfile(void)
+{
+	return NVIC_u8ActiveProfile;
+}
+
+
+
+
+/**
+ *  brief 	 	Apply Priority Table
+ *  details		Sets the priority grouping, then the pre-emption and sub-priority of every entry
+ *  param [in]	PriorityGroup  SCB_PRIORITYGROUP_x the table was planned for
+ *  param [in]	Table          Priorities to apply
+ *  param [in]	Entries        Number of entries
+ *  return		OK / ERROR (an entry out of range, the others are applied)
+ */
+States_Type NVIC_ApplyPriorityTable(u32 PriorityGroup, const NVIC_PriorityEntry_Type * Table, u32 Entries)
+{
+	States_Type State = OK;
+	u32 Index;
+
+	if(Table == NULL)
+	{
+		return ERROR;
+	}
+
+	SCB_SetPriorityGrouping(PriorityGroup);
+	for(Index = 0; Index < Entries; Index++)
+	{
+		if(NVIC_SetGroupedPriority(Table[Index].IRQn, Table[Index].PreemptPriority, Table[Index].SubPriority) != OK)
+		{
+			State = ERROR;
+		}
+	}
+	return State;
+}
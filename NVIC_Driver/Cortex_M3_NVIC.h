@@ -33,7 +33,27 @@ typedef struct {
 
 #define NVIC_BASE_ADDRESS  0xE000E100   // Base address of NVIC in memory
 
+#ifndef CORE_SIMULATION
 #define NVIC  ((NVIC_Type *) NVIC_BASE_ADDRESS)
+#else
+/* Host build: the driver works on the register model of Host_Tools/NVIC_Sim */
+extern NVIC_Type NVIC_SimRegisters;
+#define NVIC  (&NVIC_SimRegisters)
+#endif
+
+#define NVIC_REG_WORDS        8U          // Number of words in ISER/ICER/ISPR/ICPR/IABR
+#define NVIC_DEVICE_WORDS     2U          // Words holding the 60 interrupts of the STM32F103 (IRQn 0..59)
+
+#define NVIC_PRIO_BITS        4U          // Priority bits implemented by the STM32F103 (upper nibble of each byte)
+
+/* Number of pre-emption and sub-priority bits for a PRIGROUP value (SCB_PRIORITYGROUP_0 .. SCB_PRIORITYGROUP_4) */
+#define NVIC_PREEMPT_BITS(PriorityGroup)  (((7UL - ((PriorityGroup) & 0X07UL)) > NVIC_PRIO_BITS) ? NVIC_PRIO_BITS : (7UL - ((PriorityGroup) & 0X07UL)))
+#define NVIC_SUB_BITS(PriorityGroup)      (((((PriorityGroup) & 0X07UL) + NVIC_PRIO_BITS) < 7UL) ? 0UL : ((((PriorityGroup) & 0X07UL) + NVIC_PRIO_BITS) - 7UL))
+
+/* Register word and bit mask of an interrupt, to build the masks of the bulk APIs
+ * e.g. NVIC_EnableIRQMask(0, NVIC_IRQ_MASK(EXTI0_IRQn) | NVIC_IRQ_MASK(USART1_IRQn)) */
+#define NVIC_IRQ_WORD(IRQn)   (((u32)(IRQn)) >> 5)
+#define NVIC_IRQ_MASK(IRQn)   (1UL << (((u32)(IRQn)) & 0X1FUL))
 
 
 /*******Vector Table STM32F103C8T6***********/
@@ -113,6 +133,76 @@ typedef enum {
 
 /******************************End Data Type Section***********************/
 
+/*******************************Start Config Section************************/
+
+/* 1: NVIC_EnterCritical/NVIC_ExitCritical record the longest time each section held the mask */
+#ifndef NVIC_CRITICAL_DEBUG
+#define NVIC_CRITICAL_DEBUG     0
+#endif
+
+#define NVIC_CRITICAL_SECTIONS  16U       // Number of section IDs tracked in debug mode
+#define NVIC_CRITICAL_MAX_DEPTH 8U        // Deepest nesting timed in debug mode
+
+/* 1: NVIC_PROFILE_ENTER/NVIC_PROFILE_EXIT collect per interrupt timing, 0: they compile to nothing */
+#ifndef NVIC_PROFILE_ENABLE
+#define NVIC_PROFILE_ENABLE     0
+#endif
+
+#define NVIC_PROFILE_SLOTS      (16U + 60U) // System exceptions + STM32F103 interrupts (index IRQn + 16)
+#define NVIC_PROFILE_MAX_DEPTH  8U        // Deepest interrupt nesting tracked by the profiler
+
+#define NVIC_CONTEXT_PROFILES   4U        // Interrupt configurations that NVIC_SwitchProfile can select
+
+/*******************************End Config Section**************************/
+
+/*******************************Start Profiler Section**********************/
+
+/* Statistics of one interrupt, as returned by NVIC_GetProfile */
+typedef struct {
+    u32 Count;                  // Number of executions
+    u64 TotalCycles;            // Execution time, nested interrupts excluded
+    u32 MaxCycles;              // Longest execution
+    u32 AverageCycles;          // TotalCycles / Count
+    u32 MaxLatencyCycles;       // Longest NVIC_PROFILE_MARK_PENDING -> entry delay
+    u8  MaxNesting;             // Deepest nesting level seen at entry (1 = not nested)
+} NVIC_Profile_Type;
+
+#if NVIC_PROFILE_ENABLE == 1
+/* First and last statement of an instrumented handler */
+#define NVIC_PROFILE_ENTER(IRQn)        NVIC_ProfileEnter(IRQn)
+#define NVIC_PROFILE_EXIT(IRQn)         NVIC_ProfileExit(IRQn)
+/* Called by the code that raises the interrupt (or at the event time) to measure the latency */
+#define NVIC_PROFILE_MARK_PENDING(IRQn) NVIC_ProfileMarkPending(IRQn)
+#else
+#define NVIC_PROFILE_ENTER(IRQn)        ((void)0)
+#define NVIC_PROFILE_EXIT(IRQn)         ((void)0)
+#define NVIC_PROFILE_MARK_PENDING(IRQn) ((void)0)
+#endif
+
+/*******************************End Profiler Section************************/
+
+/*******************************Start Context Section***********************/
+
+#define NVIC_DEVICE_IP_WORDS    15U       // NVIC_IP bytes of IRQn 0..59 read as 32-bit words
+#define NVIC_CONTEXT_NONE       0XFFU     // NVIC_GetActiveProfile before any NVIC_SwitchProfile
+
+/* Complete interrupt configuration, as saved by NVIC_SaveContext */
+typedef struct {
+    u32 Enable[NVIC_DEVICE_WORDS];      // NVIC_ISER words
+    u32 Priority[NVIC_DEVICE_IP_WORDS]; // NVIC_IP, four interrupts per word (IRQn 4n in the low byte)
+    u32 SystemPriority[3];              // SCB->SHPR1 .. SHPR3
+    u32 PriorityGroup;                  // AIRCR PRIGROUP (SCB_PRIORITYGROUP_x)
+} NVIC_Context_Type;
+
+/* One line of a boot-time priority table (e.g. generated by Host_Tools/IRQ_Planner) */
+typedef struct {
+    IRQn_Type IRQn;
+    u8 PreemptPriority;                 // Group priority for the table's PRIGROUP
+    u8 SubPriority;
+} NVIC_PriorityEntry_Type;
+
+/*******************************End Context Section*************************/
+
 
 /***************Start Software Interface Section**************************/
 
@@ -168,6 +258,7 @@ u32 NVIC_GetActive(IRQn_Type IRQn);
   * @brief  Sets the priority for the specified interrupt.
   * @param  IRQn: The interrupt number to set the priority for.
   *         This parameter can be an enumerator of type IRQn_Type.
+  *         System handlers (MemoryManagement_IRQn .. SysTick_IRQn) are set in SCB->SHPR1..3.
   * @param  Priority: The priority value to be set for the specified interrupt.
   *         This parameter should be of type u32.
   *         The valid range of priority values depends on the microcontroller architecture.
@@ -188,4 +279,284 @@ void NVIC_SetPriority(IRQn_Type IRQn, u32 Priority);
  * @return The priority level of the specified interrupt request.
  */
 u32 NVIC_GetPriority(IRQn_Type IRQn);
+
+
+/**
+ *  brief 	 	Enable Interrupts (bulk)
+ *  details		Enables every interrupt selected in Mask with a single store to NVIC_ISER[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_EnableIRQMask(u32 Word, u32 Mask);
+
+
+/**
+ *  brief 	 	Disable Interrupts (bulk)
+ *  details		Disables every interrupt selected in Mask with a single store to NVIC_ICER[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_DisableIRQMask(u32 Word, u32 Mask);
+
+
+/**
+ *  brief 	 	Set Pending Interrupts (bulk)
+ *  details		Sets the pending bit of every interrupt selected in Mask with a single store to NVIC_ISPR[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_SetPendingIRQMask(u32 Word, u32 Mask);
+
+
+/**
+ *  brief 	 	Clear Pending Interrupts (bulk)
+ *  details		Clears the pending bit of every interrupt selected in Mask with a single store to NVIC_ICPR[Word]
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  param [in]	Mask  One bit per interrupt of the word (see NVIC_IRQ_MASK)
+ */
+void NVIC_ClearPendingIRQMask(u32 Word, u32 Mask);
+
+
+/**
+ *  brief 	 	Trigger Interrupt
+ *  details		Pends an interrupt from software through NVIC_STIR (single store)
+ *  param [in]	IRQn Device specific interrupt number
+ *  note		IRQn must not be negative
+ */
+void NVIC_TriggerIRQ(IRQn_Type IRQn);
+
+
+/**
+ *  brief 	 	Get Pending Interrupt
+ *  details		Reads the pending register in the NVIC and returns the pending bit of a device specific interrupt
+ *  param [in]	IRQn Device specific interrupt number
+ *  return		0  Interrupt is not pending
+ *  return 		1  Interrupt is pending
+ *  note		IRQn must not be negative
+ */
+u32 NVIC_GetPendingIRQ(IRQn_Type IRQn);
+
+
+/**
+ *  brief 	 	Get Enabled Mask
+ *  details		Snapshot of NVIC_ISER[Word], one bit per interrupt (see NVIC_IRQ_MASK)
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  return		Enabled interrupts of the word, 0 for an invalid word
+ */
+u32 NVIC_GetEnabledMask(u32 Word);
+
+
+/**
+ *  brief 	 	Get Pending Mask
+ *  details		Snapshot of NVIC_ISPR[Word], one bit per interrupt (see NVIC_IRQ_MASK)
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  return		Pending interrupts of the word, 0 for an invalid word
+ */
+u32 NVIC_GetPendingMask(u32 Word);
+
+
+/**
+ *  brief 	 	Get Active Mask
+ *  details		Snapshot of NVIC_IABR[Word], one bit per interrupt (see NVIC_IRQ_MASK)
+ *  param [in]	Word  Register index: IRQn 0..31 are in word 0, IRQn 32..63 in word 1
+ *  return		Active interrupts of the word, 0 for an invalid word
+ */
+u32 NVIC_GetActiveMask(u32 Word);
+
+
+/**
+ *  brief 	 	Get Highest Pending Interrupt
+ *  details		Scans the pending and enabled interrupts with CLZ and returns the one the NVIC would
+ *  			take next: lowest NVIC_IP value, lowest IRQn on a tie
+ *  param [out]	pIRQn  Receives the interrupt number
+ *  return		OK     An enabled interrupt is pending
+ *  return		ERROR  No enabled interrupt is pending
+ */
+States_Type NVIC_GetHighestPendingIRQ(IRQn_Type * pIRQn);
+
+
+/**
+ *  brief 	 	Get Highest Active Interrupt
+ *  details		Scans the active interrupts with CLZ and returns the one with the highest priority,
+ *  			i.e. the handler that blocks every interrupt of equal or lower priority
+ *  param [out]	pIRQn  Receives the interrupt number
+ *  return		OK     A device interrupt is active
+ *  return		ERROR  No device interrupt is active
+ */
+States_Type NVIC_GetHighestActiveIRQ(IRQn_Type * pIRQn);
+
+
+/**
+ *  brief 	 	Encode Priority
+ *  details		Builds the priority value of NVIC_SetPriority from a pre-emption priority and a
+ *  			sub-priority for a given priority grouping
+ *  param [in]	PriorityGroup    Priority grouping (SCB_PRIORITYGROUP_0 .. SCB_PRIORITYGROUP_4)
+ *  param [in]	PreemptPriority  Pre-emption priority (extra bits are dropped)
+ *  param [in]	SubPriority      Sub-priority (extra bits are dropped)
+ *  return		Priority value for NVIC_SetPriority
+ */
+u32 NVIC_EncodePriority(u32 PriorityGroup, u32 PreemptPriority, u32 SubPriority);
+
+
+/**
+ *  brief 	 	Decode Priority
+ *  details		Splits a priority value of NVIC_GetPriority into pre-emption priority and sub-priority
+ *  param [in]	Priority         Priority value (as returned by NVIC_GetPriority)
+ *  param [in]	PriorityGroup    Priority grouping (SCB_PRIORITYGROUP_0 .. SCB_PRIORITYGROUP_4)
+ *  param [out]	pPreemptPriority Pre-emption priority
+ *  param [out]	pSubPriority     Sub-priority
+ */
+void NVIC_DecodePriority(u32 Priority, u32 PriorityGroup, u32 * pPreemptPriority, u32 * pSubPriority);
+
+
+/**
+ *  brief 	 	Set Grouped Priority
+ *  details		Sets the priority of an interrupt or system handler from a pre-emption priority and a
+ *  			sub-priority, checked against the active grouping (set by SCB_SetPriorityGrouping)
+ *  param [in]	IRQn             Interrupt number (system handlers MemoryManagement_IRQn .. SysTick_IRQn included)
+ *  param [in]	PreemptPriority  Pre-emption priority
+ *  param [in]	SubPriority      Sub-priority
+ *  return		OK     The priority is set
+ *  return		ERROR  A value does not fit in the bits of the active grouping, nothing is changed
+ */
+States_Type NVIC_SetGroupedPriority(IRQn_Type IRQn, u32 PreemptPriority, u32 SubPriority);
+
+
+/**
+ *  brief 	 	Get Grouped Priority
+ *  details		Reads the priority of an interrupt or system handler split with the active grouping
+ *  param [in]	IRQn             Interrupt number
+ *  param [out]	pPreemptPriority Pre-emption priority
+ *  param [out]	pSubPriority     Sub-priority
+ */
+void NVIC_GetGroupedPriority(IRQn_Type IRQn, u32 * pPreemptPriority, u32 * pSubPriority);
+
+
+/**
+ *  brief 	 	Enter Critical Section
+ *  details		Masks, through BASEPRI_MAX, every interrupt whose pre-emption priority is numerically
+ *  			greater than or equal to Priority. More urgent interrupts (lower value) keep running.
+ *  			Sections can be nested: the mask is only ever raised, and each exit restores the
+ *  			value saved by the matching entry.
+ *  param [in]	Priority   Threshold in NVIC_SetPriority units (1 .. 15, 0 is treated as 1 since
+ *  			BASEPRI can not mask priority 0)
+ *  param [in]	SectionId  Section identifier for the debug statistics (0 .. NVIC_CRITICAL_SECTIONS-1)
+ *  return		State to pass to NVIC_ExitCritical
+ */
+u32 NVIC_EnterCritical(u32 Priority, u8 SectionId);
+
+
+/**
+ *  brief 	 	Exit Critical Section
+ *  details		Restores the BASEPRI value saved by the matching NVIC_EnterCritical
+ *  param [in]	State      Value returned by NVIC_EnterCritical
+ *  param [in]	SectionId  Same identifier as given to NVIC_EnterCritical
+ */
+void NVIC_ExitCritical(u32 State, u8 SectionId);
+
+
+/**
+ *  brief 	 	Get Critical Section Max Time
+ *  details		Returns the longest time a section held the mask (NVIC_CRITICAL_DEBUG only)
+ *  param [in]	SectionId  Section identifier
+ *  return		Longest hold time in DWT cycles, 0 when debug mode is off
+ */
+u32 NVIC_GetCriticalMaxCycles(u8 SectionId);
+
+
+/**
+ *  brief 	 	Reset Critical Section Statistics
+ *  details		Clears the longest hold times recorded in debug mode
+ */
+void NVIC_ResetCriticalStats(void);
+
+
+#if NVIC_PROFILE_ENABLE == 1
+/**
+ *  brief 	 	Profile Enter / Exit / Mark Pending
+ *  details		Used through NVIC_PROFILE_ENTER, NVIC_PROFILE_EXIT and NVIC_PROFILE_MARK_PENDING
+ *  param [in]	IRQn  Interrupt number of the handler
+ */
+void NVIC_ProfileEnter(IRQn_Type IRQn);
+void NVIC_ProfileExit(IRQn_Type IRQn);
+void NVIC_ProfileMarkPending(IRQn_Type IRQn);
+
+
+/**
+ *  brief 	 	Get Profile
+ *  details		Copies the statistics of one interrupt (consistent snapshot for handlers of priority 1 .. 15)
+ *  param [in]	IRQn      Interrupt number
+ *  param [out]	Snapshot  Receives the statistics
+ */
+void NVIC_GetProfile(IRQn_Type IRQn, NVIC_Profile_Type * Snapshot);
+
+
+/**
+ *  brief 	 	Reset Profile
+ *  details		Clears the statistics of every interrupt
+ */
+void NVIC_ResetProfile(void);
+#endif
+
+
+/**
+ *  brief 	 	Save Context
+ *  details		Snapshots the enables and priorities of the device interrupts, the system handler
+ *  			priorities and the priority grouping with word-wide reads
+ *  param [out]	Context  Receives the configuration
+ */
+void NVIC_SaveContext(NVIC_Context_Type * Context);
+
+
+/**
+ *  brief 	 	Restore Context
+ *  details		Disables every device interrupt, writes the grouping and all priorities with word-wide
+ *  			stores, then enables the saved set. Pending bits are kept.
+ *  param [in]	Context  Configuration to apply
+ *  note		Call from thread mode or with interrupts masked, an ISR changing the enables in
+ *  			between is overwritten.
+ */
+void NVIC_RestoreContext(const NVIC_Context_Type * Context);
+
+
+/**
+ *  brief 	 	Register Profile
+ *  details		Stores a predefined configuration (e.g. run, low power, safe state) under an ID.
+ *  			Only the pointer is kept, the context can be a const table in flash.
+ *  param [in]	ProfileId  0 .. NVIC_CONTEXT_PROFILES-1
+ *  param [in]	Context    Configuration of the profile
+ *  return		OK     Profile registered
+ *  return		ERROR  Invalid ID or NULL context
+ */
+States_Type NVIC_RegisterProfile(u8 ProfileId, const NVIC_Context_Type * Context);
+
+
+/**
+ *  brief 	 	Switch Profile
+ *  details		Applies a registered profile with NVIC_RestoreContext
+ *  param [in]	ProfileId  0 .. NVIC_CONTEXT_PROFILES-1
+ *  return		OK     Profile applied
+ *  return		ERROR  Invalid or unregistered ID
+ */
+States_Type NVIC_SwitchProfile(u8 ProfileId);
+
+
+/**
+ *  brief 	 	Get Active Profile
+ *  return		ID of the last profile applied by NVIC_SwitchProfile, NVIC_CONTEXT_NONE if none
+ */
+u8 NVIC_GetActiveProfile(void);
+
+
+/**
+ *  brief 	 	Apply Priority Table
+ *  details		Sets the priority grouping, then the pre-emption and sub-priority of every entry
+ *  param [in]	PriorityGroup  SCB_PRIORITYGROUP_x the table was planned for
+ *  param [in]	Table          Priorities to apply
+ *  param [in]	Entries        Number of entries
+ *  return		OK     Every entry applied
+ *  return		ERROR  At least one entry was out of range for the grouping (the others are applied)
+ */
+States_Type NVIC_ApplyPriorityTable(u32 PriorityGroup, const NVIC_PriorityEntry_Type * Table, u32 Entries);
+
 #endif /* NVIC_H_ */
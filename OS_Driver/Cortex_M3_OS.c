@@ -0,0 +1,520 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_OS.c
+ * @author         : Ahmed Khaled
+ * @brief          : Preemptive Micro-Kernel Source File
+ ******************************************************************************/
+
+
+#include "OS/Cortex_M3_OS.h"
+#include "NVIC/Cortex_M3_NVIC.h"
+#include "SCB/Cortex_M3_SCB.h"
+#include "SysTick/Cortex_M3_SysTick.h"
+#include "Libraries/CORE_INTRINSICS.h"
+#if OS_SWITCH_PROFILE == 1
+#include "DWT/Cortex_M3_DWT.h"
+#endif
+
+
+#define OS_INITIAL_XPSR				0X01000000UL		/*Thumb state*/
+#define OS_READY_BIT(Priority)		(1UL << (31U - (Priority)))
+
+#define OS_CRITICAL_ID				0U
+
+
+/* Running task and the one PendSV switches to (used by PendSV_Handler, not static) */
+OS_Task_Type * volatile OS_CurrentTask = NULL;
+OS_Task_Type * volatile OS_NextTask    = NULL;
+
+/* Ready queues: bit (31 - priority) of the bitmap is set when the queue is not empty */
+static u32 OS_u32ReadyMask = 0;
+static OS_Task_Type * OS_ReadyHead[OS_PRIORITIES];
+static OS_Task_Type * OS_ReadyTail[OS_PRIORITIES];
+
+static OS_Task_Type * OS_Tasks[OS_MAX_TASKS];
+static u8 OS_u8TasksNum = 0;
+static volatile u32 OS_u32Ticks = 0;
+
+static OS_Task_Type OS_IdleTask;
+static u32 OS_u32IdleStack[OS_IDLE_STACK_WORDS] __attribute__((aligned(8)));
+
+#if OS_SWITCH_PROFILE == 1
+static volatile u32 OS_u32YieldStart = 0;
+static u32 OS_u32SwitchLast = 0;
+static u32 OS_u32SwitchMax  = 0;
+#endif
+
+
+static void OS_ReadyPush(OS_Task_Type * Task)
+{
+	Task->Next = NULL;
+	if(OS_ReadyHead[Task->Priority] == NULL)
+	{
+		OS_ReadyHead[Task->Priority] = Task;
+	}
+	else
+	{
+		OS_ReadyTail[Task->Priority]->Next = Task;
+	}
+	OS_ReadyTail[Task->Priority] = Task;
+	OS_u32ReadyMask |= OS_READY_BIT(Task->Priority);
+}
+
+
+static void OS_ReadyRemove(OS_Task_Type * Task)
+{
+	OS_Task_Type * Previous = NULL;
+	OS_Task_Type * Current  = OS_ReadyHead[Task->Priority];
+
+	while((Current != NULL) && (Current != Task))
+	{
+		Previous = Current;
+		Current  = Current->Next;
+	}
+	if(Current == NULL)
+	{
+		return;
+	}
+
+	if(Previous == NULL)
+	{
+		OS_ReadyHead[Task->Priority] = Task->Next;
+	}
+	else
+	{
+		Previous->Next = Task->Next;
+	}
+	if(OS_ReadyTail[Task->Priority] == Task)
+	{
+		OS_ReadyTail[Task->Priority] = Previous;
+	}
+	if(OS_ReadyHead[Task->Priority] == NULL)
+	{
+		OS_u32ReadyMask &= ~OS_READY_BIT(Task->Priority);
+	}
+	Task->Next = NULL;
+}
+
+
+/* Moves the head of a ready queue to its end (round robin) */
+static void OS_ReadyRotate(u8 Priority)
+{
+	OS_Task_Type * Head = OS_ReadyHead[Priority];
+
+	if((Head != NULL) && (Head->Next != NULL))
+	{
+		OS_ReadyHead[Priority] = Head->Next;
+		Head->Next = NULL;
+		OS_ReadyTail[Priority]->Next = Head;
+		OS_ReadyTail[Priority] = Head;
+	}
+}
+
+
+/* Selects the head of the most urgent ready queue, pends PendSV when it is another task */
+static u8 OS_Schedule(void)
+{
+	u32 Priority = OS_HighestReadyPriority();
+
+#if OS_SWITCH_PROFILE == 1
+	/* A yield start is only valid up to the switch it requested: the task that resumed after it
+	 * (not necessarily inside OS_Yield) always schedules again before it can yield */
+	OS_u32YieldStart = 0;
+#endif
+	if(Priority >= OS_PRIORITIES)
+	{
+		return 0;
+	}
+
+	OS_NextTask = OS_ReadyHead[Priority];
+	if(OS_NextTask == OS_CurrentTask)
+	{
+		return 0;
+	}
+#if OS_TICKLESS == 1
+	/* A task woken by an interrupt during a tickless sleep needs the periodic tick again */
+	if(OS_CurrentTask == &OS_IdleTask)
+	{
+		SysTick_ExitTickless();
+	}
+#endif
+	SCB->ICSR = (1UL << SCB_ICSR_PENDSVSET_POS);
+	return 1;
+}
+
+
+/* Return address of every task: a finished task leaves the scheduling */
+static void OS_TaskExit(void)
+{
+	u32 State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+
+	OS_ReadyRemove(OS_CurrentTask);
+	OS_CurrentTask->State = OS_TASK_DONE;
+	(void)OS_Schedule();
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+
+	for(;;)
+	{
+		/*Switched out by PendSV*/
+	}
+}
+
+
+#if OS_TICKLESS == 1
+/* Ticks until the first delayed task wakes up */
+static u32 OS_NextWakeUp(void)
+{
+	u32 State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+	u32 Ticks = SYSTICK_TICKLESS_FOREVER;
+	u8 Index;
+
+	for(Index = 0; Index < OS_u8TasksNum; Index++)
+	{
+		if((OS_Tasks[Index]->State == OS_TASK_DELAYED) && (OS_Tasks[Index]->Delay < Ticks))
+		{
+			Ticks = OS_Tasks[Index]->Delay;
+		}
+	}
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+
+	return Ticks;
+}
+#endif
+
+
+static void OS_IdleFunction(void * Arg)
+{
+	(void)Arg;
+	for(;;)
+	{
+#if OS_TICKLESS == 1
+		/* The skipped ticks are replayed through OS_Tick, so the delays stay exact */
+		if(SysTick_EnterTickless(OS_NextWakeUp()) != 0)
+		{
+			OS_IDLE_HOOK();
+			SysTick_ExitTickless();
+			continue;
+		}
+#endif
+		OS_IDLE_HOOK();
+	}
+}
+
+
+
+
+
+/**
+ *  brief 	 	Highest Ready Priority
+ *  details		CLZ over the ready bitmap (bit 31 is priority 0)
+ * 	return		Most urgent priority with a ready task, OS_PRIORITIES when none
+ */
+
+u32 OS_HighestReadyPriority(void)
+{
+	return (OS_u32ReadyMask == 0) ? OS_PRIORITIES : CORE_CLZ(OS_u32ReadyMask);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Init
+ *  details		Clears the ready queues and creates the idle task
+ */
+
+void OS_Init(void)
+{
+	u32 Priority;
+
+	for(Priority = 0; Priority < OS_PRIORITIES; Priority++)
+	{
+		OS_ReadyHead[Priority] = NULL;
+		OS_ReadyTail[Priority] = NULL;
+	}
+	OS_u32ReadyMask = 0;
+	OS_u8TasksNum   = 0;
+	OS_u32Ticks     = 0;
+	OS_CurrentTask  = NULL;
+	OS_NextTask     = NULL;
+#if OS_SWITCH_PROFILE == 1
+	OS_u32YieldStart = 0;
+	OS_u32SwitchLast = 0;
+	OS_u32SwitchMax  = 0;
+#endif
+
+	/* Only the idle task may use the idle priority */
+	(void)OS_CreateTask(&OS_IdleTask, OS_IdleFunction, NULL, OS_u32IdleStack, OS_IDLE_STACK_WORDS, OS_IDLE_PRIORITY);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Create Task
+ *  details		Builds the initial exception frame on the task stack and makes the task ready
+ * 	return		OK / ERROR
+ */
+
+States_Type OS_CreateTask(OS_Task_Type * Task, OS_TaskFunction_Type Function, void * Arg,
+						  u32 * Stack, u32 Words, u8 Priority)
+{
+	u32 * Top;
+	u32 Index;
+	u32 State;
+
+	if((Task == NULL) || (Function == NULL) || (Stack == NULL) || (Words < OS_STACK_FRAME_WORDS + 2U) ||
+	   (Priority >= OS_PRIORITIES) || ((Priority == OS_IDLE_PRIORITY) && (Task != &OS_IdleTask)) ||
+	   (OS_u8TasksNum >= OS_MAX_TASKS))
+	{
+		return ERROR;
+	}
+
+	/* AAPCS: 8-byte aligned stack at the task entry */
+	Top = (u32 *)((u32)(Stack + Words) & ~7UL);
+
+	/* Exception frame popped by the first exception return */
+	*(--Top) = OS_INITIAL_XPSR;
+	*(--Top) = (u32)Function & ~1UL;			// PC
+	*(--Top) = (u32)OS_TaskExit;				// LR
+	*(--Top) = 0;								// R12
+	*(--Top) = 0;								// R3
+	*(--Top) = 0;								// R2
+	*(--Top) = 0;								// R1
+	*(--Top) = (u32)Arg;						// R0
+
+	/* R11 .. R4 restored by PendSV_Handler */
+	for(Index = 0; Index < 8U; Index++)
+	{
+		*(--Top) = 0;
+	}
+
+	Task->StackPointer = Top;
+	Task->Priority     = Priority;
+	Task->Delay        = 0;
+	Task->State        = OS_TASK_READY;
+
+	State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+	OS_Tasks[OS_u8TasksNum] = Task;
+	OS_u8TasksNum++;
+	OS_ReadyPush(Task);
+	if(OS_CurrentTask != NULL)
+	{
+		(void)OS_Schedule();
+	}
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Start
+ *  details		Sets PendSV / SysTick priorities, starts the tick and switches to the first task
+ */
+
+void OS_Start(void)
+{
+	u32 PriorityGroup = SCB_GetPriorityGrouping();
+	u32 LowestPreempt = (1UL << NVIC_PREEMPT_BITS(PriorityGroup)) - 1UL;
+	u32 LowestSub     = (1UL << NVIC_SUB_BITS(PriorityGroup)) - 1UL;
+	u32 State;
+
+	SysTick_SetTickHook(OS_Tick);
+	SysTick_Init();
+
+	/* Same pre-emption level: the tick never pre-empts a context switch, they tail-chain */
+	(void)NVIC_SetGroupedPriority(PendSV_IRQn, LowestPreempt, LowestSub);
+	(void)NVIC_SetGroupedPriority(SysTick_IRQn, LowestPreempt, 0);
+
+
+	State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+	OS_CurrentTask = NULL;
+	(void)OS_Schedule();
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+
+	for(;;)
+	{
+		/*PendSV switches to the first task, the main stack becomes the handler stack*/
+	}
+}
+
+
+
+
+
+/**
+ *  brief 	 	Delay
+ *  param [in]	Ticks  Ticks to wait (0 only yields)
+ */
+
+void OS_Delay(u32 Ticks)
+{
+	u32 State;
+
+	if(Ticks == 0)
+	{
+		OS_Yield();
+		return;
+	}
+
+	State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+	OS_ReadyRemove(OS_CurrentTask);
+	OS_CurrentTask->Delay = Ticks;
+	OS_CurrentTask->State = OS_TASK_DELAYED;
+	(void)OS_Schedule();
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Yield
+ *  details		Moves the calling task to the end of its ready queue and lets the next one run
+ */
+
+void OS_Yield(void)
+{
+	u32 State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+
+	OS_ReadyRotate(OS_CurrentTask->Priority);
+	if(OS_Schedule() == 1)
+	{
+#if OS_SWITCH_PROFILE == 1
+		OS_u32YieldStart = DWT_GET_CYCLES();
+#endif
+	}
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+
+	/* PendSV runs here, the next lines execute when this task is resumed */
+#if OS_SWITCH_PROFILE == 1
+	/* Set only when the previous task yielded straight into this one (see OS_Schedule) */
+	State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+	if(OS_u32YieldStart != 0)
+	{
+		OS_u32SwitchLast = DWT_GET_CYCLES() - OS_u32YieldStart;
+		OS_u32YieldStart = 0;
+		if(OS_u32SwitchLast > OS_u32SwitchMax)
+		{
+			OS_u32SwitchMax = OS_u32SwitchLast;
+		}
+	}
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+#endif
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Ticks
+ * 	return		Ticks since OS_Start
+ */
+
+u32 OS_GetTicks(void)
+{
+	return OS_u32Ticks;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Tick
+ *  details		Wakes delayed tasks, rotates the running priority and requests a switch when needed
+ */
+
+void OS_Tick(void)
+{
+	u32 State = NVIC_EnterCritical(OS_KERNEL_PRIORITY, OS_CRITICAL_ID);
+	u8 Index;
+
+	OS_u32Ticks++;
+
+	for(Index = 0; Index < OS_u8TasksNum; Index++)
+	{
+		if(OS_Tasks[Index]->State == OS_TASK_DELAYED)
+		{
+			OS_Tasks[Index]->Delay--;
+			if(OS_Tasks[Index]->Delay == 0)
+			{
+				OS_Tasks[Index]->State = OS_TASK_READY;
+				OS_ReadyPush(OS_Tasks[Index]);
+			}
+		}
+	}
+
+	/* Time slice between the ready tasks of the running priority */
+	if((OS_CurrentTask != NULL) && (OS_CurrentTask->State == OS_TASK_READY))
+	{
+		OS_ReadyRotate(OS_CurrentTask->Priority);
+	}
+
+	(void)OS_Schedule();
+	NVIC_ExitCritical(State, OS_CRITICAL_ID);
+}
+
+
+
+#if OS_SWITCH_PROFILE == 1
+/**
+ *  brief 	 	Get Switch Cycles
+ *  param [out]	pLast  Last measurement
+ *  param [out]	pMax   Longest measurement
+ */
+
+void OS_GetSwitchCycles(u32 * pLast, u32 * pMax)
+{
+	if(pLast != NULL)
+	{
+		*pLast = OS_u32SwitchLast;
+	}
+	if(pMax != NULL)
+	{
+		*pMax = OS_u32SwitchMax;
+	}
+}
+#endif
+
+
+
+#if defined(__arm__)
+/*
+ * Context switch. The hardware already stacked R0-R3, R12, LR, PC and xPSR on the PSP of
+ * the running task, R4-R11 are saved here and the PSP is kept in its control block.
+ * The first switch (OS_CurrentTask NULL) comes from OS_Start on the main stack and saves nothing.
+ */
+__attribute__((naked)) void PendSV_Handler(void)
+{
+	__asm volatile (
+		"cpsid   i                                  \n"
+		"movw    r2, #:lower16:OS_CurrentTask       \n"
+		"movt    r2, #:upper16:OS_CurrentTask       \n"
+		"ldr     r1, [r2]                           \n"
+		"cbz     r1, 1f                             \n"
+		"mrs     r0, psp                            \n"
+		"stmdb   r0!, {r4-r11}                      \n"
+		"str     r0, [r1]                           \n"
+		"1:                                         \n"
+		"movw    r3, #:lower16:OS_NextTask          \n"
+		"movt    r3, #:upper16:OS_NextTask          \n"
+		"ldr     r1, [r3]                           \n"
+		"str     r1, [r2]                           \n"
+		"ldr     r0, [r1]                           \n"
+		"ldmia   r0!, {r4-r11}                      \n"
+		"msr     psp, r0                            \n"
+		"mvn     lr, #2                             \n"		/* EXC_RETURN 0xFFFFFFFD: thread mode, PSP */
+		"cpsie   i                                  \n"
+		"bx      lr                                 \n"
+	);
+}
+#endif
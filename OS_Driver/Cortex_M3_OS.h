@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_OS.h
+ * @author         : Ahmed Khaled
+ * @brief          : Preemptive Micro-Kernel Header File
+ ******************************************************************************/
+
+#ifndef CORTEX_M3_OS_H_
+#define CORTEX_M3_OS_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+/***************************************End Include Section*****************/
+
+/********************************************Config Section Start********************************/
+
+#define OS_MAX_TASKS						8U					/*Tasks including the idle task*/
+#define OS_PRIORITIES						32U					/*Task priorities, 0 most urgent (one bit each in the ready bitmap)*/
+#define OS_IDLE_PRIORITY					(OS_PRIORITIES - 1U)
+#define OS_IDLE_STACK_WORDS					64U
+
+/* The tick (delays and round-robin time slice) is the SysTick driver tick, SYSTICK_TICK_HZ */
+
+/* 1: the idle task stops the periodic tick until the next task delay or SysTick timer */
+#ifndef OS_TICKLESS
+#define OS_TICKLESS							0
+#endif
+
+/* NVIC_SetPriority threshold of the kernel critical sections: interrupts with a lower value
+ * (more urgent) are never masked by the kernel and must not call OS functions */
+#ifndef OS_KERNEL_PRIORITY
+#define OS_KERNEL_PRIORITY					5U
+#endif
+
+/* Run by the idle task on each loop */
+#ifndef OS_IDLE_HOOK
+#define OS_IDLE_HOOK()						CORE_WFI()
+#endif
+
+/* 1: OS_Yield measures the cycles from the yield to the resume of the next task (DWT) */
+#ifndef OS_SWITCH_PROFILE
+#define OS_SWITCH_PROFILE					0
+#endif
+
+/********************************************Config Section End**********************************/
+
+/******************************Start Data Type Section***********************/
+
+typedef void (*OS_TaskFunction_Type)(void * Arg);
+
+/* Task control block, allocated by the application */
+typedef struct OS_Task {
+	u32 * StackPointer;					// Saved PSP, must stay the first member (used by PendSV_Handler)
+	struct OS_Task * Next;				// Next task of the same priority in the ready queue
+	u32 Delay;							// Ticks left while delayed
+	u8  Priority;
+	u8  State;							// OS_TASK_READY, OS_TASK_DELAYED or OS_TASK_DONE
+} OS_Task_Type;
+
+/******************************End Data Type Section***********************/
+
+/********************************************Macro Section Start********************************/
+
+#define OS_TASK_READY						0U
+#define OS_TASK_DELAYED						1U
+#define OS_TASK_DONE						2U
+
+#define OS_STACK_FRAME_WORDS				16U					/*R4-R11 + exception frame, minimum stack use*/
+
+/********************************************Macro End Section**********************************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Init
+ *  details		Clears the ready queues and creates the idle task
+ */
+
+void OS_Init(void);
+
+/**
+ *  brief 	 	Create Task
+ *  details		Builds the initial exception frame on the task stack and makes the task ready.
+ *  			A task that returns is removed from scheduling.
+ *  param [in]	Task      Control block (owned by the application)
+ *  param [in]	Function  Task body
+ *  param [in]	Arg       Argument passed to Function
+ *  param [in]	Stack     Stack memory
+ *  param [in]	Words     Stack size in words (>= OS_STACK_FRAME_WORDS plus the task needs)
+ *  param [in]	Priority  0 (most urgent) .. OS_IDLE_PRIORITY - 1
+ * 	return		OK / ERROR (invalid argument or OS_MAX_TASKS reached)
+ */
+
+States_Type OS_CreateTask(OS_Task_Type * Task, OS_TaskFunction_Type Function, void * Arg,
+						  u32 * Stack, u32 Words, u8 Priority);
+
+/**
+ *  brief 	 	Start
+ *  details		Sets PendSV to the lowest and SysTick to the lowest pre-emption level of the
+ *  			active grouping (SCB_SetPriorityGrouping must be called before), starts the SysTick
+ *  			timebase with OS_Tick as tick hook and switches to the most urgent task. Does not return.
+ */
+
+void OS_Start(void);
+
+/**
+ *  brief 	 	Delay
+ *  details		Blocks the calling task for a number of ticks (0 only yields)
+ *  param [in]	Ticks  Ticks to wait
+ */
+
+void OS_Delay(u32 Ticks);
+
+/**
+ *  brief 	 	Yield
+ *  details		Moves the calling task to the end of its ready queue and lets the next one run
+ */
+
+void OS_Yield(void);
+
+/**
+ *  brief 	 	Get Ticks
+ * 	return		Ticks since OS_Start
+ */
+
+u32 OS_GetTicks(void);
+
+/**
+ *  brief 	 	Tick
+ *  details		Kernel part of the tick interrupt: wakes delayed tasks, rotates the running
+ *  			priority (time slice) and requests a switch when needed
+ */
+
+void OS_Tick(void);
+
+/**
+ *  brief 	 	Highest Ready Priority
+ *  details		CLZ over the ready bitmap (bit 31 is priority 0)
+ * 	return		Most urgent priority with a ready task, OS_PRIORITIES when none
+ */
+
+u32 OS_HighestReadyPriority(void);
+
+#if OS_SWITCH_PROFILE == 1
+/**
+ *  brief 	 	Get Switch Cycles
+ *  details		Cycles from OS_Yield to the first instruction of the next task (PendSV entry,
+ *  			register save / restore and exception return included). Only switches between
+ *  			two yielding tasks are measured: a switch scheduled by anything else (tick,
+ *  			delay, interrupt) discards the pending start.
+ *  param [out]	pLast  Last measurement
+ *  param [out]	pMax   Longest measurement
+ */
+
+void OS_GetSwitchCycles(u32 * pLast, u32 * pMax);
+#endif
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* CORTEX_M3_OS_H_ */
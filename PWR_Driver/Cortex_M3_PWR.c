@@ -0,0 +1,101 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_PWR.c
+ * @author         : Ahmed Khaled
+ * @brief          : Contain the declarations to PWR
+ ******************************************************************************/
+
+#include "PWR/Cortex_M3_PWR.h"
+#include "Libraries/BIT_MATH.h"
+#include "Libraries/CORE_INTRINSICS.h"
+#include "RCC/Cortex_M3_RCC.h"
+#include "SCB/Cortex_M3_SCB.h"
+
+
+// Wake-to-full-speed time of the last and of the slowest Stop exit
+static u32 PWR_u32WakeLatencyUs = 0;
+static u32 PWR_u32MaxWakeLatencyUs = 0;
+
+
+/**
+ * @brief Enables the PWR interface clock.
+ */
+void PWR_voidInit(void)
+{
+	RCC_voidAcquirePeripheralClk(APB1_BUS, PWREN_APB1);
+	PWR_u32WakeLatencyUs = 0;
+	PWR_u32MaxWakeLatencyUs = 0;
+}
+
+
+/**
+ * @brief Enters Stop mode and brings the saved clock tree back on wake-up.
+ *
+ * @param Copy_u8Regulator PWR_REGULATOR_ON or PWR_REGULATOR_LOW_POWER.
+ *
+ * @retval OK    Woken up, the saved clock tree runs again.
+ * @retval ERROR Woken up on HSI, an oscillator of the saved tree did not start.
+ */
+States_Type PWR_enuEnterStop(u8 Copy_u8Regulator)
+{
+	RCC_ClockContext_Type Local_Context;
+	States_Type Local_enuState;
+	u32 Local_u32Cr;
+
+	RCC_voidSaveClockContext(&Local_Context);
+
+	// Stop (not Standby) on deep sleep, regulator mode, old wake-up flag cleared
+	Local_u32Cr = PWR->CR;
+	CLR_BIT(Local_u32Cr, PDDS_BIT);
+	if(Copy_u8Regulator == PWR_REGULATOR_LOW_POWER)
+	{
+		SET_BIT(Local_u32Cr, LPDS_BIT);
+	}
+	else
+	{
+		CLR_BIT(Local_u32Cr, LPDS_BIT);
+	}
+	SET_BIT(Local_u32Cr, CWUF_BIT);
+	PWR->CR = Local_u32Cr;
+
+	// The wake-up handler must only run once the clock tree is back
+	CORE_DISABLE_IRQ();
+	SCB_SetSleepDeep(1);
+	CORE_DSB();
+	CORE_WFI();
+	SCB_SetSleepDeep(0);
+
+	// SYSCLK is HSI here, HCLK is HSI / saved HPRE until the saved tree runs
+	Local_enuState = RCC_enuRestoreClockContext(&Local_Context, RCC_STARTUP_TIMEOUT_CYCLES);
+
+	PWR_u32WakeLatencyUs = RCC_u32GetRestoreUs();
+	if(PWR_u32WakeLatencyUs > PWR_u32MaxWakeLatencyUs)
+	{
+		PWR_u32MaxWakeLatencyUs = PWR_u32WakeLatencyUs;
+	}
+
+	CORE_ENABLE_IRQ();
+	return Local_enuState;
+}
+
+
+/**
+ * @brief Returns the wake-to-full-speed time of the last Stop exit.
+ *
+ * @retval Time in microseconds.
+ */
+u32 PWR_u32GetWakeLatencyUs(void)
+{
+	return PWR_u32WakeLatencyUs;
+}
+
+
+/**
+ * @brief Returns the longest wake-to-full-speed time since PWR_voidInit.
+ *
+ * @retval Time in microseconds.
+ */
+u32 PWR_u32GetMaxWakeLatencyUs(void)
+{
+	return PWR_u32MaxWakeLatencyUs;
+}
@@ -0,0 +1,20 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_PWR.h
+ * @author         : Ahmed Khaled
+ * @brief          : Contain the declarations to PWR
+ ******************************************************************************/
+
+#ifndef CORTEX_M3_PWR_H_
+#define CORTEX_M3_PWR_H_
+
+
+/***********************Includes Start******************/
+#include "Libraries/STD_TYPES.h"
+#include "PWR_Register.h"
+#include "PWR_Interface.h"
+/***********************Includes End********************/
+
+
+
+#endif /* CORTEX_M3_PWR_H_ */
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file           : PWR_Interface.h
+ * @author         : Ahmed Khaled
+ * @brief          : Contain the declarations to PWR function and Macros
+ ******************************************************************************/
+
+#ifndef PWR_PWR_INTERFACE_H_
+#define PWR_PWR_INTERFACE_H_
+
+
+/***********************Include Start******************/
+#include "Libraries/STD_TYPES.h"
+
+/***********************Include End*******************/
+
+/***********************Macros Start******************/
+#define PWR_REGULATOR_ON					0			/* Regulator on in Stop: faster wake-up */
+#define PWR_REGULATOR_LOW_POWER				1			/* Regulator in low-power mode in Stop: lower current */
+
+/***********************Macros End******************/
+
+/***********************Software Interface Start******************/
+
+
+/**
+ * @brief Enables the PWR interface clock (APB1 PWREN, reference counted by RCC).
+ */
+void PWR_voidInit(void);
+
+
+/**
+ * @brief Enters Stop mode and brings the saved clock tree back on wake-up.
+ *
+ * The clock tree is saved, SLEEPDEEP is set and WFI runs with PRIMASK set: a wake-up
+ * interrupt (EXTI line, RTC alarm, ...) ends Stop, RCC_enuRestoreClockContext brings the
+ * PLL and prescalers back, and only then the interrupt handler runs, at full speed.
+ *
+ * @param Copy_u8Regulator PWR_REGULATOR_ON or PWR_REGULATOR_LOW_POWER.
+ *
+ * @retval OK    Woken up, the saved clock tree runs again.
+ * @retval ERROR Woken up on HSI, an oscillator of the saved tree did not start.
+ */
+States_Type PWR_enuEnterStop(u8 Copy_u8Regulator);
+
+
+/**
+ * @brief Returns the wake-to-full-speed time of the last Stop exit.
+ *
+ * Measured from the first instruction after WFI to the switch to the saved SYSCLK
+ * (the regulator and HSI start-up before it are not visible to the core).
+ *
+ * @retval Time in microseconds.
+ */
+u32 PWR_u32GetWakeLatencyUs(void);
+
+
+/**
+ * @brief Returns the longest wake-to-full-speed time since PWR_voidInit.
+ *
+ * @retval Time in microseconds.
+ */
+u32 PWR_u32GetMaxWakeLatencyUs(void);
+
+
+/***********************Software Interface End******************/
+
+
+
+#endif /* PWR_PWR_INTERFACE_H_ */
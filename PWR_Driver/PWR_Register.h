@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file           : PWR_Register.h
+ * @author         : Ahmed Khaled
+ * @brief          : Contain the declarations to PWR Registers
+ ******************************************************************************/
+
+#ifndef PWR_REGISTER_H_
+#define PWR_REGISTER_H_
+
+
+/***********************Includes Start******************/
+#include "Libraries/STD_TYPES.h"
+/***********************Includes End********************/
+
+/***********************Data Type Start******************/
+typedef struct {
+    volatile u32 CR;          // Offset: 0x00 - Power Control Register
+    volatile u32 CSR;         // Offset: 0x04 - Power Control/Status Register
+} PWR_TypeDef;
+/***********************Data Type End******************/
+
+/***********************Macros Start******************/
+// PWR register base address
+#define PWR_BASE					0X40007000UL
+
+// PWR peripheral instance
+#define PWR							((PWR_TypeDef *) PWR_BASE)
+
+// PWR_CR bit positions
+#define LPDS_BIT					0U			/* Voltage regulator in low-power mode during Stop */
+#define PDDS_BIT					1U			/* Standby (1) or Stop (0) on deep sleep */
+#define CWUF_BIT					2U			/* Clear wake-up flag */
+#define CSBF_BIT					3U			/* Clear standby flag */
+#define DBP_BIT						8U			/* Disable backup domain write protection */
+
+// PWR_CSR bit positions
+#define WUF_BIT						0U			/* Wake-up flag */
+#define SBF_BIT						1U			/* Standby flag */
+/***********************Macros End******************/
+
+
+#endif /* PWR_REGISTER_H_ */
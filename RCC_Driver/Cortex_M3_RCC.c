@@ -7,6 +7,307 @@
 
 #include "RCC/Cortex_M3_RCC.h"
 #include "Libraries/BIT_MATH.h"
+#include "Libraries/BIT_BAND.h"
+#include "Libraries/CORE_INTRINSICS.h"
+#include "RCC/RCC_Config.h"
+#include "RCC/RCC_Private.h"
+#include "DWT/Cortex_M3_DWT.h"
+
+
+/* AHB dividers and the matching HPRE codes, ordered from the fastest to the slowest */
+static const u16 RCC_u16AHBDividers[RCC_AHB_DIVIDERS_NUM] = {1, 2, 4, 8, 16, 64, 128, 256, 512};
+static const u8  RCC_u8AHBCodes[RCC_AHB_DIVIDERS_NUM] =
+{
+	AHB_PRESCALER_NOT_DIVIDED, AHB_PRESCALER_DIVIDED_BY_2, AHB_PRESCALER_DIVIDED_BY_4,
+	AHB_PRESCALER_DIVIDED_BY_8, AHB_PRESCALER_DIVIDED_BY_16, AHB_PRESCALER_DIVIDED_BY_64,
+	AHB_PRESCALER_DIVIDED_BY_128, AHB_PRESCALER_DIVIDED_BY_256, AHB_PRESCALER_DIVIDED_BY_512
+};
+
+/* APB dividers and the matching PPRE codes (same codes for APB1 and APB2) */
+static const u16 RCC_u16APBDividers[RCC_APB_DIVIDERS_NUM] = {1, 2, 4, 8, 16};
+static const u8  RCC_u8APBCodes[RCC_APB_DIVIDERS_NUM] =
+{
+	APB1_PRESCALER_DIV_NONE, APB1_PRESCALER_DIV_2, APB1_PRESCALER_DIV_4,
+	APB1_PRESCALER_DIV_8, APB1_PRESCALER_DIV_16
+};
+
+
+/* Frequencies of the clock tree, reset state: everything runs from HSI */
+static RCC_ClockFreq_Type RCC_ClockTable =
+{
+	RCC_HSI_FREQUENCY_HZ,
+	{RCC_HSI_FREQUENCY_HZ, RCC_HSI_FREQUENCY_HZ, RCC_HSI_FREQUENCY_HZ},
+	{RCC_HSI_FREQUENCY_HZ, RCC_HSI_FREQUENCY_HZ, RCC_HSI_FREQUENCY_HZ}
+};
+
+/* Frequency of the external crystal, updated by RCC_enuSetClockConfig */
+static u32 RCC_u32HSEFrequency = RCC_HSE_FREQUENCY_HZ;
+
+/* Functions to call after each clock change */
+static void (*RCC_pvClockCallbacks[RCC_MAX_CLOCK_CALLBACKS])(void) = {NULL};
+
+
+/* Start-up time of HSI, HSE and PLL in cycles, indexed by RCC_HSI, RCC_HSE and RCC_PLL */
+static u32 RCC_u32StartupCycles[3] = {0};
+
+/* State of the asynchronous bring-up */
+static u8  RCC_u8AsyncSource = RCC_HSI;
+static u8  RCC_u8AsyncStage  = RCC_ASYNC_IDLE;
+static u32 RCC_u32AsyncStart = 0;
+
+
+/* Number of users of each peripheral clock, indexed by bus ID and peripheral ID */
+static volatile u8 RCC_u8ClkRefCount[RCC_BUSES_NUM][RCC_PERIPHERALS_PER_BUS] = {{0}};
+
+/* Last clock tree that used the crystal (whichever API set it up), restored after a CSS failure */
+static RCC_ClockContext_Type RCC_CSSContext;
+static RCC_ClockFreq_Type RCC_CSSClockTable;
+static u8  RCC_u8CSSContextValid = 0;
+
+/* Clock Security System state */
+static volatile u8  RCC_u8CSSState = RCC_CSS_NORMAL;
+static volatile u32 RCC_u32CSSEvents = 0;
+static volatile u8  RCC_u8CSSRebuildPending = 0;
+static u32 RCC_u32CSSRetryStart = 0;
+
+/* Requested clock tree of each performance level */
+static const RCC_ClockTarget_Type RCC_PerfTargets[RCC_PERF_LEVELS_NUM] =
+{
+	{RCC_HSE_FREQUENCY_HZ, RCC_SYSCLK_MAX_HZ, 0,                     0, 0},	/* RCC_PERF_LEVEL_HIGH   */
+	{RCC_HSE_FREQUENCY_HZ, RCC_SYSCLK_MAX_HZ, RCC_SYSCLK_MAX_HZ / 2, 0, 0},	/* RCC_PERF_LEVEL_MEDIUM */
+	{0,                    RCC_HSI_FREQUENCY_HZ, 0,                  0, 0}	/* RCC_PERF_LEVEL_LOW    */
+};
+
+/* Solved configuration of each performance level (valid when its bit is set in RCC_u8PerfSolved) */
+static RCC_ClockConfig_Type RCC_PerfConfigs[RCC_PERF_LEVELS_NUM];
+static u8  RCC_u8PerfSolved = 0;
+static u8  RCC_u8PerfLevel  = RCC_PERF_LEVEL_NONE;
+static u32 RCC_u32PerfTransitionUs[RCC_PERF_LEVELS_NUM] = {0};
+
+// Time of the running switch: DWT segments converted with the HCLK of each (RCC_voidTransitionMark)
+static u64 RCC_u64TransitionNs = 0;
+static u32 RCC_u32TransitionMark = 0;
+
+// Duration of the last clock context restore and the core clock it was counted in
+static u32 RCC_u32RestoreCycles = 0;
+static u32 RCC_u32RestoreHCLK_Hz = RCC_HSI_FREQUENCY_HZ;
+
+
+/*
+ * Function: RCC_u8SelectDivider
+ * Description: Returns the index of the smallest divider that brings InputHz down to LimitHz or below.
+ *              Returns Count when no divider of the table is large enough.
+ */
+static u8 RCC_u8SelectDivider(u32 InputHz, u32 LimitHz, const u16 * Dividers, u8 Count)
+{
+	u8 Local_u8Index;
+
+	for(Local_u8Index = 0; Local_u8Index < Count; Local_u8Index++)
+	{
+		if((InputHz / Dividers[Local_u8Index]) <= LimitHz)
+		{
+			break;
+		}
+	}
+	return Local_u8Index;
+}
+
+
+/*
+ * Function: RCC_voidSetFlashLatency
+ * Description: Programs the flash wait states and keeps the prefetch buffer enabled.
+ */
+static void RCC_voidSetFlashLatency(u8 Copy_u8Latency)
+{
+	FLASH->ACR = (FLASH->ACR & FLASH_LATENCY_MASK) | (1UL << PRFTBE_BIT) | (u32)Copy_u8Latency;
+}
+
+
+
+/*
+ * Function: RCC_enuWaitReady
+ * Description: Polls a ready flag of RCC_CR until it is set or the cycle budget runs out.
+ *              The time spent is stored in the start-up table under Copy_u8Source.
+ */
+static States_Type RCC_enuWaitReady(u8 Copy_u8Source, u8 Copy_u8ReadyBit, u32 Copy_u32TimeoutCycles)
+{
+	u32 Local_u32Start = DWT_GET_CYCLES();
+	u32 Local_u32Elapsed = 0;
+
+	while(GET_BIT(RCC->CR, Copy_u8ReadyBit) != 1)
+	{
+		Local_u32Elapsed = DWT_GET_CYCLES() - Local_u32Start;
+		if(Local_u32Elapsed >= Copy_u32TimeoutCycles)
+		{
+			RCC_u32StartupCycles[Copy_u8Source] = Copy_u32TimeoutCycles;
+			return ERROR;
+		}
+	}
+	RCC_u32StartupCycles[Copy_u8Source] = DWT_GET_CYCLES() - Local_u32Start;
+	return OK;
+}
+
+
+/*
+ * Function: RCC_voidFallbackToHSI
+ * Description: Makes HSI drive SYSCLK and turns the PLL and (optionally) HSE off after a failed bring-up.
+ */
+static void RCC_voidFallbackToHSI(u8 Copy_u8StopHSE)
+{
+	SET_BIT(RCC->CR, HSION_BIT);
+	while(GET_BIT(RCC->CR, HSIRDY_BIT) != 1);			/*HSI is always running after reset*/
+	RCC->CFGR &= SW_MASK;
+	while(RCC_GET_SWS() != RCC_HSI);
+
+	CLR_BIT(RCC->CR, PLLON_BIT);
+	if(Copy_u8StopHSE == 1)
+	{
+		CLR_BIT(RCC->CR, HSEON_BIT);
+	}
+}
+
+
+/*
+ * Function: RCC_voidWritePrescaler
+ * Description: Writes the AHB, APB1 and APB2 prescaler fields of RCC_CFGR.
+ *              The APB fields are written first unless Copy_u8AHBFirst is 1.
+ */
+static void RCC_voidWritePrescaler(const Prescaler_State * Prescaler_Val, u8 Copy_u8AHBFirst)
+{
+	if(Copy_u8AHBFirst == 1)
+	{
+		RCC -> CFGR = ((RCC -> CFGR) & AHP_PRE_MASK) | ((u32)Prescaler_Val->AHB_Divide << HPRE_POS);
+	}
+
+	RCC->CFGR &=ABP1_PRE_MASK;											/* Clear existing APB1 prescaler bits*/
+	RCC->CFGR |=((u32)(Prescaler_Val->APB1_Divide) << PPRE1_POS);		/*Set the new APB1 prescaler values*/
+
+	RCC->CFGR &=ABP2_PRE_MASK;											/* Clear existing APB2 prescaler bits*/
+	RCC->CFGR |=((u32)(Prescaler_Val->APB2_Divide) << PPRE2_POS);		/*Set the new APB2 prescaler values*/
+
+	if(Copy_u8AHBFirst != 1)
+	{
+		RCC -> CFGR = ((RCC -> CFGR) & AHP_PRE_MASK) | ((u32)Prescaler_Val->AHB_Divide << HPRE_POS);  /* Clear existing AHB prescaler bits and set the new AHB prescaler values*/
+	}
+}
+
+
+/*
+ * Function: RCC_u16GetAHBDivider
+ * Description: Decodes the HPRE field of a RCC_CFGR value (codes 0b1000..0b1111 map to the dividers 2..512).
+ */
+static u16 RCC_u16GetAHBDivider(u32 Copy_u32Cfgr)
+{
+	u32 Local_u32Code = (Copy_u32Cfgr >> HPRE_POS) & 0X0FUL;
+	u8  Local_u8Index = (Local_u32Code < AHB_PRESCALER_DIVIDED_BY_2) ? 0 : (u8)(Local_u32Code - (AHB_PRESCALER_DIVIDED_BY_2 - 1));
+
+	return RCC_u16AHBDividers[Local_u8Index];
+}
+
+
+/*
+ * Function: RCC_voidTransitionMark
+ * Description: Ends a timed segment of a clock switch: adds the DWT cycles since the previous mark,
+ *              converted with the HCLK that ran during them, to RCC_u64TransitionNs.
+ */
+static void RCC_voidTransitionMark(u32 Copy_u32HCLK_Hz)
+{
+	u32 Local_u32Now = DWT_GET_CYCLES();
+
+	RCC_u64TransitionNs  += ((u64)(Local_u32Now - RCC_u32TransitionMark) * 1000000000ULL) / Copy_u32HCLK_Hz;
+	RCC_u32TransitionMark = Local_u32Now;
+}
+
+
+/*
+ * Function: RCC_voidUpdateClockTable
+ * Description: Decodes RCC_CFGR once into the frequency table and notifies the registered callbacks.
+ *              Must be called after every change of the clock source or of the prescalers.
+ */
+static void RCC_voidUpdateClockTable(void)
+{
+	u32 Local_u32Cfgr = RCC->CFGR;
+	u32 Local_u32Code;
+	u32 Local_u32Mul;
+	u16 Local_u16APB1Div;
+	u16 Local_u16APB2Div;
+	u8  Local_u8Index;
+
+	// Any clock change leaves the current performance level (RCC_enuSetPerformanceLevel sets it back)
+	RCC_u8PerfLevel = RCC_PERF_LEVEL_NONE;
+
+	// SYSCLK from the switch status
+	switch((Local_u32Cfgr >> SWS_POS) & 0X03UL)
+	{
+	case RCC_HSE:
+		RCC_ClockTable.SYSCLK_Hz = RCC_u32HSEFrequency;
+		break;
+
+	case RCC_PLL:
+		Local_u32Mul = ((Local_u32Cfgr >> PLLMUL_POS) & 0X0FUL) + RCC_PLL_MUL_MIN;
+		if(Local_u32Mul > RCC_PLL_MUL_MAX)
+		{
+			Local_u32Mul = RCC_PLL_MUL_MAX;						/* Code 0b1111 is also x16 */
+		}
+		if(GET_BIT(Local_u32Cfgr, PLLSRC_BIT) == 0)
+		{
+			RCC_ClockTable.SYSCLK_Hz = (RCC_HSI_FREQUENCY_HZ / 2) * Local_u32Mul;
+		}
+		else if(GET_BIT(Local_u32Cfgr, PLLXTPRE_BIT) == 1)
+		{
+			RCC_ClockTable.SYSCLK_Hz = (RCC_u32HSEFrequency / 2) * Local_u32Mul;
+		}
+		else
+		{
+			RCC_ClockTable.SYSCLK_Hz = RCC_u32HSEFrequency * Local_u32Mul;
+		}
+		break;
+
+	default:
+		RCC_ClockTable.SYSCLK_Hz = RCC_HSI_FREQUENCY_HZ;
+		break;
+	}
+
+	RCC_ClockTable.Bus_Hz[AHB_BUS] = RCC_ClockTable.SYSCLK_Hz / RCC_u16GetAHBDivider(Local_u32Cfgr);
+
+	// PCLK1/PCLK2: PPRE codes 0b100..0b111 map to the dividers 2..16
+	Local_u32Code = (Local_u32Cfgr >> PPRE1_POS) & 0X07UL;
+	Local_u8Index = (Local_u32Code < APB1_PRESCALER_DIV_2) ? 0 : (u8)(Local_u32Code - (APB1_PRESCALER_DIV_2 - 1));
+	Local_u16APB1Div = RCC_u16APBDividers[Local_u8Index];
+
+	Local_u32Code = (Local_u32Cfgr >> PPRE2_POS) & 0X07UL;
+	Local_u8Index = (Local_u32Code < APB2_PRESCALER_DIVIDED_BY_2) ? 0 : (u8)(Local_u32Code - (APB2_PRESCALER_DIVIDED_BY_2 - 1));
+	Local_u16APB2Div = RCC_u16APBDividers[Local_u8Index];
+
+	RCC_ClockTable.Bus_Hz[APB1_BUS] = RCC_ClockTable.Bus_Hz[AHB_BUS] / Local_u16APB1Div;
+	RCC_ClockTable.Bus_Hz[APB2_BUS] = RCC_ClockTable.Bus_Hz[AHB_BUS] / Local_u16APB2Div;
+
+	// Timers run at 2 x PCLK whenever their APB prescaler is not 1
+	RCC_ClockTable.Timer_Hz[AHB_BUS]  = RCC_ClockTable.Bus_Hz[AHB_BUS];
+	RCC_ClockTable.Timer_Hz[APB1_BUS] = (Local_u16APB1Div == 1) ? RCC_ClockTable.Bus_Hz[APB1_BUS] : (RCC_ClockTable.Bus_Hz[APB1_BUS] * 2);
+	RCC_ClockTable.Timer_Hz[APB2_BUS] = (Local_u16APB2Div == 1) ? RCC_ClockTable.Bus_Hz[APB2_BUS] : (RCC_ClockTable.Bus_Hz[APB2_BUS] * 2);
+
+	// A crystal based tree is now active: this is the tree a CSS recovery brings back
+	if((((Local_u32Cfgr >> SWS_POS) & 0X03UL) == RCC_HSE) ||
+	   ((((Local_u32Cfgr >> SWS_POS) & 0X03UL) == RCC_PLL) && (GET_BIT(Local_u32Cfgr, PLLSRC_BIT) == 1)))
+	{
+		RCC_CSSContext.CR    = RCC->CR;
+		RCC_CSSContext.CFGR  = Local_u32Cfgr;
+		RCC_CSSContext.ACR   = FLASH->ACR;
+		RCC_CSSClockTable    = RCC_ClockTable;
+		RCC_u8CSSContextValid = 1;
+		RCC_u8CSSState = RCC_CSS_NORMAL;
+	}
+
+	// Let the dependent drivers recompute their dividers
+	for(Local_u8Index = 0; Local_u8Index < RCC_MAX_CLOCK_CALLBACKS; Local_u8Index++)
+	{
+		if(RCC_pvClockCallbacks[Local_u8Index] != NULL)
+		{
+			RCC_pvClockCallbacks[Local_u8Index]();
+		}
+	}
+}
 
 
 
@@ -31,6 +332,7 @@ void RCC_voidInitSysCLK(u8 CLK_Source)
 		// Select HSE as the system clock source
 		SET_BIT(RCC->CFGR, SW0_BIT);
 		CLR_BIT(RCC->CFGR, SW1_BIT);
+		while(RCC_GET_SWS() != RCC_HSE);				/*Wait until it drives SYSCLK*/
 		break;
 
 	case RCC_HSI:
@@ -41,6 +343,7 @@ void RCC_voidInitSysCLK(u8 CLK_Source)
 		// Select HSI as the system clock source
 		CLR_BIT(RCC->CFGR, SW0_BIT);
 		CLR_BIT(RCC->CFGR, SW1_BIT);
+		while(RCC_GET_SWS() != RCC_HSI);				/*Wait until it drives SYSCLK*/
 		break;
 
 	case RCC_PLL:
@@ -51,11 +354,15 @@ void RCC_voidInitSysCLK(u8 CLK_Source)
 		// Select PLL as the system clock source
 		CLR_BIT(RCC->CFGR, SW0_BIT);
 		SET_BIT(RCC->CFGR, SW1_BIT);
+		while(RCC_GET_SWS() != RCC_PLL);				/*Wait until it drives SYSCLK*/
 		break;
 	}
 
 	// Enable Clock Security System (CSS)
 	SET_BIT(RCC->CR, CSS_BIT);
+
+	// Refresh the cached frequencies
+	RCC_voidUpdateClockTable();
 }
 
 
@@ -83,15 +390,10 @@ void RCC_voidInitSysCLK(u8 CLK_Source)
  */
 void RCC_voidSysCLKPrescaler(Prescaler_State * Prescaler_Val)
 {
+	RCC_voidWritePrescaler(Prescaler_Val, 0);
 
-
-	RCC->CFGR &=ABP1_PRE_MASK;							/* Clear existing APB1 prescaler bits*/
-	RCC->CFGR |=((Prescaler_Val->APB1_Divide) <<8);		/*Set the new APB1 prescaler values*/
-
-	RCC->CFGR &=ABP2_PRE_MASK;                         /* Clear existing APB2 prescaler bits*/
-	RCC->CFGR |=((Prescaler_Val->APB2_Divide) <<11);   /*Set the new APB2 prescaler values*/
-
-	RCC -> CFGR = ((RCC -> CFGR) & AHP_PRE_MASK) | (Prescaler_Val->AHB_Divide << 4);  /* Clear existing AHB prescaler bits and set the new AHB prescaler values*/
+	// Refresh the cached frequencies
+	RCC_voidUpdateClockTable();
 }
 
 
@@ -171,3 +473,1237 @@ void RCC_voidDisablePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID)
             break;
     }
 }
+
+
+
+/**
+ * @brief Enables the clock of a peripheral with a single atomic store.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidEnablePeripheralClkAtomic(u8 Copy_u8BusID, u8 Copy_u8PeripheralID)
+{
+	// Write 1 to the bit-band alias of the enable bit
+	switch(Copy_u8BusID)
+	{
+	case AHB_BUS:BB_SET_BIT(RCC->AHBENR,Copy_u8PeripheralID);break;
+	case APB1_BUS:BB_SET_BIT(RCC->APB1ENR,Copy_u8PeripheralID);break;
+	case APB2_BUS:BB_SET_BIT(RCC->APB2ENR,Copy_u8PeripheralID);break;
+	}
+}
+
+
+/**
+ * @brief Disables the clock of a peripheral with a single atomic store.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidDisablePeripheralClkAtomic(u8 Copy_u8BusID, u8 Copy_u8PeripheralID)
+{
+	// Write 0 to the bit-band alias of the enable bit
+	switch(Copy_u8BusID)
+	{
+	case AHB_BUS:BB_CLR_BIT(RCC->AHBENR,Copy_u8PeripheralID);break;
+	case APB1_BUS:BB_CLR_BIT(RCC->APB1ENR,Copy_u8PeripheralID);break;
+	case APB2_BUS:BB_CLR_BIT(RCC->APB2ENR,Copy_u8PeripheralID);break;
+	}
+}
+
+
+/**
+ * @brief Takes a reference on the clock of a peripheral.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidAcquirePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID)
+{
+	volatile u8 * Local_pu8Count;
+	u8 Local_u8Count;
+
+	if((Copy_u8BusID >= RCC_BUSES_NUM) || (Copy_u8PeripheralID >= RCC_PERIPHERALS_PER_BUS))
+	{
+		return;
+	}
+	Local_pu8Count = &RCC_u8ClkRefCount[Copy_u8BusID][Copy_u8PeripheralID];
+
+	// Atomic increment (saturates at 255)
+	do
+	{
+		Local_u8Count = CORE_LDREXB(Local_pu8Count);
+		if(Local_u8Count == 0XFF)
+		{
+			CORE_CLREX();
+			break;
+		}
+	}while(CORE_STREXB(Local_u8Count + 1, Local_pu8Count) != 0);
+
+	// Always (re)set the enable bit: an ISR may have taken its reference between our
+	// increment and this store, it must not find the clock off. The store is idempotent.
+	RCC_voidEnablePeripheralClkAtomic(Copy_u8BusID, Copy_u8PeripheralID);
+}
+
+
+/**
+ * @brief Drops a reference on the clock of a peripheral.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidReleasePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID)
+{
+	volatile u8 * Local_pu8Count;
+	u8 Local_u8Count;
+
+	if((Copy_u8BusID >= RCC_BUSES_NUM) || (Copy_u8PeripheralID >= RCC_PERIPHERALS_PER_BUS))
+	{
+		return;
+	}
+	Local_pu8Count = &RCC_u8ClkRefCount[Copy_u8BusID][Copy_u8PeripheralID];
+
+	while(1)
+	{
+		Local_u8Count = CORE_LDREXB(Local_pu8Count);
+		if(Local_u8Count == 0)
+		{
+			// Unbalanced release: nothing to do
+			CORE_CLREX();
+			return;
+		}
+
+		// Last user: gate the clock inside the exclusive section
+		if(Local_u8Count == 1)
+		{
+			RCC_voidDisablePeripheralClkAtomic(Copy_u8BusID, Copy_u8PeripheralID);
+		}
+
+		if(CORE_STREXB(Local_u8Count - 1, Local_pu8Count) == 0)
+		{
+			return;
+		}
+
+		// An interrupt took a reference meanwhile (the exception cleared the monitor):
+		// give the clock back and retry with the new count
+		if(Local_u8Count == 1)
+		{
+			RCC_voidEnablePeripheralClkAtomic(Copy_u8BusID, Copy_u8PeripheralID);
+		}
+	}
+}
+
+
+/**
+ * @brief Returns the number of references held on the clock of a peripheral.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID.
+ *
+ * @retval Reference count, 0 for an invalid bus or peripheral ID.
+ */
+u8 RCC_u8GetPeripheralRefCount(u8 Copy_u8BusID, u8 Copy_u8PeripheralID)
+{
+	if((Copy_u8BusID >= RCC_BUSES_NUM) || (Copy_u8PeripheralID >= RCC_PERIPHERALS_PER_BUS))
+	{
+		return 0;
+	}
+	return RCC_u8ClkRefCount[Copy_u8BusID][Copy_u8PeripheralID];
+}
+
+
+/**
+ * @brief Reads the set of peripherals whose clock is currently enabled.
+ *
+ * @param Copy_Mask Pointer to the structure that receives AHBENR, APB1ENR and APB2ENR.
+ */
+void RCC_voidGetEnabledPeripherals(RCC_PeripheralMask_Type * Copy_Mask)
+{
+	if(Copy_Mask == NULL)
+	{
+		return;
+	}
+	Copy_Mask->AHB_Mask  = RCC->AHBENR;
+	Copy_Mask->APB1_Mask = RCC->APB1ENR;
+	Copy_Mask->APB2_Mask = RCC->APB2ENR;
+}
+
+
+/**
+ * @brief Enables the clocks of several peripherals at once.
+ *
+ * @param Copy_Mask Pointer to the peripherals to enable.
+ */
+void RCC_voidEnablePeripheralMask(const RCC_PeripheralMask_Type * Copy_Mask)
+{
+	if(Copy_Mask == NULL)
+	{
+		return;
+	}
+
+	// One read-modify-write per register, skipped when nothing changes on that bus
+	if(Copy_Mask->AHB_Mask != 0)
+	{
+		RCC->AHBENR |= Copy_Mask->AHB_Mask;
+	}
+	if(Copy_Mask->APB1_Mask != 0)
+	{
+		RCC->APB1ENR |= Copy_Mask->APB1_Mask;
+	}
+	if(Copy_Mask->APB2_Mask != 0)
+	{
+		RCC->APB2ENR |= Copy_Mask->APB2_Mask;
+	}
+}
+
+
+/**
+ * @brief Disables the clocks of several peripherals at once.
+ *
+ * @param Copy_Mask Pointer to the peripherals to disable.
+ */
+void RCC_voidDisablePeripheralMask(const RCC_PeripheralMask_Type * Copy_Mask)
+{
+	if(Copy_Mask == NULL)
+	{
+		return;
+	}
+
+	// One read-modify-write per register, skipped when nothing changes on that bus
+	if(Copy_Mask->AHB_Mask != 0)
+	{
+		RCC->AHBENR &= ~(Copy_Mask->AHB_Mask);
+	}
+	if(Copy_Mask->APB1_Mask != 0)
+	{
+		RCC->APB1ENR &= ~(Copy_Mask->APB1_Mask);
+	}
+	if(Copy_Mask->APB2_Mask != 0)
+	{
+		RCC->APB2ENR &= ~(Copy_Mask->APB2_Mask);
+	}
+}
+
+
+/**
+ * @brief Resets several APB peripherals at once.
+ *
+ * @param Copy_Mask Pointer to the peripherals to reset (AHB_Mask is ignored).
+ */
+void RCC_voidResetPeripheralMask(const RCC_PeripheralMask_Type * Copy_Mask)
+{
+	if(Copy_Mask == NULL)
+	{
+		return;
+	}
+
+	// Assert the reset of every selected peripheral with one write per register
+	if(Copy_Mask->APB1_Mask != 0)
+	{
+		RCC->APB1RSTR |= Copy_Mask->APB1_Mask;
+	}
+	if(Copy_Mask->APB2_Mask != 0)
+	{
+		RCC->APB2RSTR |= Copy_Mask->APB2_Mask;
+	}
+
+	// Release it the same way
+	if(Copy_Mask->APB1_Mask != 0)
+	{
+		RCC->APB1RSTR &= ~(Copy_Mask->APB1_Mask);
+	}
+	if(Copy_Mask->APB2_Mask != 0)
+	{
+		RCC->APB2RSTR &= ~(Copy_Mask->APB2_Mask);
+	}
+}
+
+
+/**
+ * @brief Recovers wedged peripherals without a system reset.
+ *
+ * @param Copy_Mask           Pointer to the peripherals to reset.
+ * @param Copy_Restore        Register values to write after the reset.
+ * @param Copy_u8RestoreCount Number of entries in Copy_Restore.
+ * @param Copy_pu32Cycles     Receives the duration of the recovery in DWT cycles (may be NULL).
+ *
+ * @retval OK    The peripherals were reset and reconfigured.
+ * @retval ERROR Invalid argument, nothing was done.
+ */
+States_Type RCC_enuRecoverPeripheral(const RCC_PeripheralMask_Type * Copy_Mask, const RCC_RegisterValue_Type * Copy_Restore,
+									 u8 Copy_u8RestoreCount, u32 * Copy_pu32Cycles)
+{
+	u32 Local_u32Start;
+	u8  Local_u8Index;
+
+	if((Copy_Mask == NULL) || ((Copy_Restore == NULL) && (Copy_u8RestoreCount != 0)))
+	{
+		return ERROR;
+	}
+
+	DWT_EnableCycleCounter();
+	Local_u32Start = DWT_GET_CYCLES();
+
+	RCC_voidResetPeripheralMask(Copy_Mask);
+
+	// Write the saved configuration back in the given order
+	for(Local_u8Index = 0; Local_u8Index < Copy_u8RestoreCount; Local_u8Index++)
+	{
+		*(Copy_Restore[Local_u8Index].Address) = Copy_Restore[Local_u8Index].Value;
+	}
+
+	if(Copy_pu32Cycles != NULL)
+	{
+		*Copy_pu32Cycles = DWT_GET_CYCLES() - Local_u32Start;
+	}
+	return OK;
+}
+
+
+/**
+ * @brief Computes a legal clock tree configuration for the requested frequencies.
+ *
+ * This function is a pure function: it does not access any register, so it can be
+ * called before the clocks are touched (or compiled and run on a host machine).
+ *
+ * @param Target Pointer to the requested frequencies.
+ * @param Config Pointer to the structure that receives the computed configuration.
+ *
+ * @retval OK    A configuration was found and written to Config.
+ * @retval ERROR The request can not be satisfied (or a NULL pointer was passed).
+ */
+States_Type RCC_enuSolveClockTree(const RCC_ClockTarget_Type * Target, RCC_ClockConfig_Type * Config)
+{
+	/* PLL entry clocks tried in order of preference: the crystal first for accuracy */
+	const u8 Local_u8PLLSources[3] = {RCC_PLL_SRC_HSE, RCC_PLL_SRC_HSE_DIV2, RCC_PLL_SRC_HSI_DIV2};
+	u32 Local_u32InputHz;
+	u32 Local_u32OutputHz;
+	u32 Local_u32LimitHz;
+	u8  Local_u8Source;
+	u8  Local_u8Mul;
+	u8  Local_u8Index;
+
+	if((Target == NULL) || (Config == NULL))
+	{
+		return ERROR;
+	}
+
+	// Reject a SYSCLK out of range and a crystal the HSE oscillator can not drive
+	if((Target->SYSCLK_Hz == 0) || (Target->SYSCLK_Hz > RCC_SYSCLK_MAX_HZ))
+	{
+		return ERROR;
+	}
+	if((Target->HSE_Hz != 0) && ((Target->HSE_Hz < RCC_HSE_MIN_HZ) || (Target->HSE_Hz > RCC_HSE_MAX_HZ)))
+	{
+		return ERROR;
+	}
+
+	Config->HSE_Hz        = Target->HSE_Hz;
+	Config->PLL_Source    = RCC_PLL_SRC_HSI_DIV2;
+	Config->PLL_Mul       = RCC_PLL_MUL_MIN;
+	Config->SYSCLK_Hz     = 0;
+
+	// An oscillator used directly is preferred when it matches the request exactly
+	if((Target->HSE_Hz != 0) && (Target->SYSCLK_Hz == Target->HSE_Hz))
+	{
+		Config->SysClk_Source = RCC_HSE;
+		Config->SYSCLK_Hz     = Target->HSE_Hz;
+	}
+	else if(Target->SYSCLK_Hz == RCC_HSI_FREQUENCY_HZ)
+	{
+		Config->SysClk_Source = RCC_HSI;
+		Config->SYSCLK_Hz     = RCC_HSI_FREQUENCY_HZ;
+	}
+	else
+	{
+		// Otherwise keep the highest PLL output that does not exceed the request
+		Config->SysClk_Source = RCC_PLL;
+		for(Local_u8Index = 0; Local_u8Index < 3; Local_u8Index++)
+		{
+			Local_u8Source = Local_u8PLLSources[Local_u8Index];
+			switch(Local_u8Source)
+			{
+			case RCC_PLL_SRC_HSE:      Local_u32InputHz = Target->HSE_Hz;            break;
+			case RCC_PLL_SRC_HSE_DIV2: Local_u32InputHz = Target->HSE_Hz / 2;        break;
+			default:                   Local_u32InputHz = RCC_HSI_FREQUENCY_HZ / 2;  break;
+			}
+			if(Local_u32InputHz == 0)
+			{
+				continue;
+			}
+
+			for(Local_u8Mul = RCC_PLL_MUL_MIN; Local_u8Mul <= RCC_PLL_MUL_MAX; Local_u8Mul++)
+			{
+				Local_u32OutputHz = Local_u32InputHz * Local_u8Mul;
+				if((Local_u32OutputHz < RCC_PLL_OUT_MIN_HZ) || (Local_u32OutputHz > Target->SYSCLK_Hz))
+				{
+					continue;
+				}
+				if(Local_u32OutputHz > Config->SYSCLK_Hz)
+				{
+					Config->PLL_Source = Local_u8Source;
+					Config->PLL_Mul    = Local_u8Mul;
+					Config->SYSCLK_Hz  = Local_u32OutputHz;
+				}
+			}
+		}
+
+		if(Config->SYSCLK_Hz == 0)
+		{
+			return ERROR;
+		}
+	}
+
+	// AHB prescaler: smallest divider that keeps HCLK at or below the request
+	Local_u32LimitHz = (Target->HCLK_Hz != 0) ? Target->HCLK_Hz : Config->SYSCLK_Hz;
+	Local_u8Index = RCC_u8SelectDivider(Config->SYSCLK_Hz, Local_u32LimitHz, RCC_u16AHBDividers, RCC_AHB_DIVIDERS_NUM);
+	if(Local_u8Index == RCC_AHB_DIVIDERS_NUM)
+	{
+		return ERROR;
+	}
+	Config->Prescaler.AHB_Divide = RCC_u8AHBCodes[Local_u8Index];
+	Config->HCLK_Hz = Config->SYSCLK_Hz / RCC_u16AHBDividers[Local_u8Index];
+
+	// APB1 prescaler: never above 36 MHz
+	Local_u32LimitHz = (Target->PCLK1_Hz != 0) ? Target->PCLK1_Hz : RCC_PCLK1_MAX_HZ;
+	if(Local_u32LimitHz > RCC_PCLK1_MAX_HZ)
+	{
+		Local_u32LimitHz = RCC_PCLK1_MAX_HZ;
+	}
+	Local_u8Index = RCC_u8SelectDivider(Config->HCLK_Hz, Local_u32LimitHz, RCC_u16APBDividers, RCC_APB_DIVIDERS_NUM);
+	if(Local_u8Index == RCC_APB_DIVIDERS_NUM)
+	{
+		return ERROR;
+	}
+	Config->Prescaler.APB1_Divide = RCC_u8APBCodes[Local_u8Index];
+	Config->PCLK1_Hz = Config->HCLK_Hz / RCC_u16APBDividers[Local_u8Index];
+
+	// APB2 prescaler: never above 72 MHz
+	Local_u32LimitHz = (Target->PCLK2_Hz != 0) ? Target->PCLK2_Hz : RCC_PCLK2_MAX_HZ;
+	if(Local_u32LimitHz > RCC_PCLK2_MAX_HZ)
+	{
+		Local_u32LimitHz = RCC_PCLK2_MAX_HZ;
+	}
+	Local_u8Index = RCC_u8SelectDivider(Config->HCLK_Hz, Local_u32LimitHz, RCC_u16APBDividers, RCC_APB_DIVIDERS_NUM);
+	if(Local_u8Index == RCC_APB_DIVIDERS_NUM)
+	{
+		return ERROR;
+	}
+	Config->Prescaler.APB2_Divide = RCC_u8APBCodes[Local_u8Index];
+	Config->PCLK2_Hz = Config->HCLK_Hz / RCC_u16APBDividers[Local_u8Index];
+
+	// Flash wait states depend on SYSCLK
+	if(Config->SYSCLK_Hz <= RCC_FLASH_0WS_MAX_HZ)
+	{
+		Config->Flash_Latency = RCC_FLASH_LATENCY_0;
+	}
+	else if(Config->SYSCLK_Hz <= RCC_FLASH_1WS_MAX_HZ)
+	{
+		Config->Flash_Latency = RCC_FLASH_LATENCY_1;
+	}
+	else
+	{
+		Config->Flash_Latency = RCC_FLASH_LATENCY_2;
+	}
+
+	return OK;
+}
+
+
+/**
+ * @brief Applies a clock tree configuration computed by RCC_enuSolveClockTree.
+ *
+ * @param Config Pointer to the configuration to apply.
+ *
+ * @retval OK    The configuration is active.
+ * @retval ERROR Config is NULL, or HSE/PLL did not become ready within
+ *               RCC_STARTUP_TIMEOUT_CYCLES (SYSCLK then runs from HSI).
+ */
+States_Type RCC_enuSetClockConfig(const RCC_ClockConfig_Type * Config)
+{
+	u32 Local_u32PLLBits = 0;
+	u32 Local_u32HSIHCLK_Hz;
+
+	if(Config == NULL)
+	{
+		return ERROR;
+	}
+
+	// PLLSRC/PLLXTPRE/PLLMUL bits wanted in RCC_CFGR
+	if(Config->SysClk_Source == RCC_PLL)
+	{
+		if(Config->PLL_Source != RCC_PLL_SRC_HSI_DIV2)
+		{
+			Local_u32PLLBits |= (1UL << PLLSRC_BIT);
+		}
+		if(Config->PLL_Source == RCC_PLL_SRC_HSE_DIV2)
+		{
+			Local_u32PLLBits |= (1UL << PLLXTPRE_BIT);
+		}
+		Local_u32PLLBits |= ((u32)(Config->PLL_Mul - RCC_PLL_MUL_MIN) << PLLMUL_POS);
+	}
+
+	// Raise the flash wait states before any clock gets faster
+	if(Config->Flash_Latency > (u8)(FLASH->ACR & ~FLASH_LATENCY_MASK))
+	{
+		RCC_voidSetFlashLatency(Config->Flash_Latency);
+	}
+
+	if((RCC_GET_SWS() == Config->SysClk_Source) &&
+	   ((Config->SysClk_Source != RCC_PLL) || ((RCC->CFGR & ~PLL_CFG_MASK) == Local_u32PLLBits)))
+	{
+		// Same source already running: only the prescalers change, no detour through HSI.
+		// The AHB divider moves first when HCLK slows down, last when it speeds up,
+		// so PCLK1 never exceeds its limit in between.
+		RCC_voidTransitionMark(RCC_ClockTable.Bus_Hz[AHB_BUS]);
+		RCC_voidWritePrescaler(&Config->Prescaler, (Config->HCLK_Hz < RCC_ClockTable.Bus_Hz[AHB_BUS]) ? 1 : 0);
+	}
+	else
+	{
+		// Run from HSI while the PLL is reprogrammed (PLL settings are locked while it is used)
+		SET_BIT(RCC->CR, HSION_BIT);
+		while(GET_BIT(RCC->CR, HSIRDY_BIT) != 1);			/*Wait until CLK is ready*/
+		RCC->CFGR &= SW_MASK;
+		while(RCC_GET_SWS() != RCC_HSI);					/*Wait until HSI drives SYSCLK*/
+
+		// The old HCLK ran up to here, HSI / old AHB prescaler until the prescalers change
+		RCC_voidTransitionMark(RCC_ClockTable.Bus_Hz[AHB_BUS]);
+		Local_u32HSIHCLK_Hz = RCC_HSI_FREQUENCY_HZ / RCC_u16GetAHBDivider(RCC->CFGR);
+
+		// Start the crystal when it feeds SYSCLK or the PLL
+		DWT_EnableCycleCounter();
+		if((Config->SysClk_Source == RCC_HSE) ||
+		   ((Config->SysClk_Source == RCC_PLL) && (Config->PLL_Source != RCC_PLL_SRC_HSI_DIV2)))
+		{
+			SET_BIT(RCC->CR, HSEON_BIT);
+			if(RCC_enuWaitReady(RCC_HSE, HSERDY_BIT, RCC_STARTUP_TIMEOUT_CYCLES) != OK)
+			{
+				RCC_voidTransitionMark(Local_u32HSIHCLK_Hz);
+				RCC_voidFallbackToHSI(1);
+				RCC_voidUpdateClockTable();
+				return ERROR;
+			}
+		}
+
+		if(Config->SysClk_Source == RCC_PLL)
+		{
+			// Stop the PLL, program entry clock and multiplier, then relock it
+			CLR_BIT(RCC->CR, PLLON_BIT);
+			while(GET_BIT(RCC->CR, PLLRDY_BIT) != 0);		/*Wait until PLL is unlocked*/
+
+			RCC->CFGR = (RCC->CFGR & PLL_CFG_MASK) | Local_u32PLLBits;
+
+			SET_BIT(RCC->CR, PLLON_BIT);
+			if(RCC_enuWaitReady(RCC_PLL, PLLRDY_BIT, RCC_STARTUP_TIMEOUT_CYCLES) != OK)
+			{
+				RCC_voidTransitionMark(Local_u32HSIHCLK_Hz);
+				RCC_voidFallbackToHSI(0);
+				RCC_voidUpdateClockTable();
+				return ERROR;
+			}
+		}
+
+		// Bus prescalers first, so APB1 never exceeds its limit after the switch
+		RCC_voidTransitionMark(Local_u32HSIHCLK_Hz);
+		RCC_voidWritePrescaler(&Config->Prescaler, 0);
+
+		// Select the new SYSCLK source and wait for the switch to take effect
+		RCC->CFGR = (RCC->CFGR & SW_MASK) | Config->SysClk_Source;
+		while(RCC_GET_SWS() != Config->SysClk_Source);
+
+		// HSI / new AHB prescaler up to here, the new HCLK from now on
+		RCC_voidTransitionMark(RCC_HSI_FREQUENCY_HZ / RCC_u16GetAHBDivider(RCC->CFGR));
+
+		// Stop the oscillators the new tree does not use (a slower level must not keep drawing their current)
+		if(Config->SysClk_Source != RCC_PLL)
+		{
+			CLR_BIT(RCC->CR, PLLON_BIT);
+		}
+		if((Config->SysClk_Source == RCC_HSI) ||
+		   ((Config->SysClk_Source == RCC_PLL) && (Config->PLL_Source == RCC_PLL_SRC_HSI_DIV2)))
+		{
+			CLR_BIT(RCC->CR, HSEON_BIT);
+		}
+	}
+
+	// Lower the flash wait states only once the clock got slower
+	if(Config->Flash_Latency < (u8)(FLASH->ACR & ~FLASH_LATENCY_MASK))
+	{
+		RCC_voidSetFlashLatency(Config->Flash_Latency);
+	}
+
+	// Enable Clock Security System (CSS)
+	SET_BIT(RCC->CR, CSS_BIT);
+
+	// Refresh the cached frequencies (also remembers a crystal based tree for the CSS recovery)
+	if(Config->HSE_Hz != 0)
+	{
+		RCC_u32HSEFrequency = Config->HSE_Hz;
+	}
+	RCC_voidUpdateClockTable();
+
+	return OK;
+}
+
+
+/**
+ * @brief Solves and applies the clock tree for the requested frequencies.
+ *
+ * @param Target Pointer to the requested frequencies.
+ *
+ * @retval OK    The requested clock tree is active.
+ * @retval ERROR The request can not be satisfied, the clocks are not changed.
+ */
+States_Type RCC_enuInitClockTree(const RCC_ClockTarget_Type * Target)
+{
+	RCC_ClockConfig_Type Local_Config;
+
+	if(RCC_enuSolveClockTree(Target, &Local_Config) != OK)
+	{
+		return ERROR;
+	}
+	return RCC_enuSetClockConfig(&Local_Config);
+}
+
+
+/**
+ * @brief Returns the current SYSCLK frequency in Hz.
+ *
+ * @retval SYSCLK frequency in Hz.
+ */
+u32 RCC_u32GetSysClockHz(void)
+{
+	return RCC_ClockTable.SYSCLK_Hz;
+}
+
+
+/**
+ * @brief Returns the current clock frequency of a bus in Hz.
+ *
+ * @param Copy_u8BusID The bus: AHB_BUS (HCLK), APB1_BUS (PCLK1) or APB2_BUS (PCLK2).
+ *
+ * @retval Bus frequency in Hz, 0 for an invalid bus ID.
+ */
+u32 RCC_u32GetBusClockHz(u8 Copy_u8BusID)
+{
+	if(Copy_u8BusID > APB2_BUS)
+	{
+		return 0;
+	}
+	return RCC_ClockTable.Bus_Hz[Copy_u8BusID];
+}
+
+
+/**
+ * @brief Returns the clock frequency fed to the timers of a bus in Hz.
+ *
+ * @param Copy_u8BusID The bus: APB1_BUS (TIM2..TIM7) or APB2_BUS (TIM1, TIM8).
+ *
+ * @retval Timer clock frequency in Hz, 0 for an invalid bus ID.
+ */
+u32 RCC_u32GetTimerClockHz(u8 Copy_u8BusID)
+{
+	if(Copy_u8BusID > APB2_BUS)
+	{
+		return 0;
+	}
+	return RCC_ClockTable.Timer_Hz[Copy_u8BusID];
+}
+
+
+/**
+ * @brief Registers a function to be called each time the clock tree changes.
+ *
+ * @param Copy_pvCallback Function to call on each clock change.
+ *
+ * @retval OK    The callback is registered.
+ * @retval ERROR NULL callback or no free slot (RCC_MAX_CLOCK_CALLBACKS reached).
+ */
+States_Type RCC_enuRegisterClockCallback(void (*Copy_pvCallback)(void))
+{
+	u8 Local_u8Index;
+
+	if(Copy_pvCallback == NULL)
+	{
+		return ERROR;
+	}
+
+	for(Local_u8Index = 0; Local_u8Index < RCC_MAX_CLOCK_CALLBACKS; Local_u8Index++)
+	{
+		if(RCC_pvClockCallbacks[Local_u8Index] == NULL)
+		{
+			RCC_pvClockCallbacks[Local_u8Index] = Copy_pvCallback;
+			return OK;
+		}
+	}
+	return ERROR;
+}
+
+
+/**
+ * @brief Initializes the system clock like RCC_voidInitSysCLK but within a bounded time.
+ *
+ * @param CLK_Source            RCC_HSI, RCC_HSE or RCC_PLL.
+ * @param Copy_u32TimeoutCycles Budget per oscillator in core clock cycles.
+ *
+ * @retval OK    The requested clock drives SYSCLK.
+ * @retval ERROR The budget ran out, SYSCLK runs from HSI.
+ */
+States_Type RCC_enuInitSysCLKTimeout(u8 CLK_Source, u32 Copy_u32TimeoutCycles)
+{
+	States_Type Local_enuState = OK;
+
+	DWT_EnableCycleCounter();
+
+	switch(CLK_Source)
+	{
+	case RCC_HSE:
+		SET_BIT(RCC->CR, HSEON_BIT);
+		Local_enuState = RCC_enuWaitReady(RCC_HSE, HSERDY_BIT, Copy_u32TimeoutCycles);
+		break;
+
+	case RCC_PLL:
+		// The crystal has to run first when it is the PLL entry clock
+		if(GET_BIT(RCC->CFGR, PLLSRC_BIT) == 1)
+		{
+			SET_BIT(RCC->CR, HSEON_BIT);
+			Local_enuState = RCC_enuWaitReady(RCC_HSE, HSERDY_BIT, Copy_u32TimeoutCycles);
+		}
+		if(Local_enuState == OK)
+		{
+			SET_BIT(RCC->CR, PLLON_BIT);
+			Local_enuState = RCC_enuWaitReady(RCC_PLL, PLLRDY_BIT, Copy_u32TimeoutCycles);
+		}
+		break;
+
+	default:
+		CLK_Source = RCC_HSI;
+		SET_BIT(RCC->CR, HSION_BIT);
+		Local_enuState = RCC_enuWaitReady(RCC_HSI, HSIRDY_BIT, Copy_u32TimeoutCycles);
+		break;
+	}
+
+	if(Local_enuState == OK)
+	{
+		// Select the requested source and wait for the switch to take effect
+		RCC->CFGR = (RCC->CFGR & SW_MASK) | CLK_Source;
+		while(RCC_GET_SWS() != CLK_Source);
+
+		// Enable Clock Security System (CSS)
+		SET_BIT(RCC->CR, CSS_BIT);
+	}
+	else
+	{
+		// Dead or slow crystal: keep running from HSI.
+		// For the PLL, HSE only has to stop when it was started as the PLL entry clock
+		RCC_voidFallbackToHSI((CLK_Source == RCC_PLL) ? (u8)GET_BIT(RCC->CFGR, PLLSRC_BIT) : 1);
+	}
+
+	RCC_voidUpdateClockTable();
+	return Local_enuState;
+}
+
+
+/**
+ * @brief Starts the bring-up of a system clock without waiting for it.
+ *
+ * @param CLK_Source RCC_HSI, RCC_HSE or RCC_PLL.
+ */
+void RCC_voidStartSysCLK(u8 CLK_Source)
+{
+	DWT_EnableCycleCounter();
+
+	RCC_u8AsyncSource = CLK_Source;
+	RCC_u32AsyncStart = DWT_GET_CYCLES();
+
+	if((CLK_Source == RCC_HSE) || ((CLK_Source == RCC_PLL) && (GET_BIT(RCC->CFGR, PLLSRC_BIT) == 1)))
+	{
+		SET_BIT(RCC->CR, HSEON_BIT);
+		RCC_u8AsyncStage = RCC_ASYNC_WAIT_HSE;
+	}
+	else if(CLK_Source == RCC_PLL)
+	{
+		// HSI/2 entry clock: the PLL can start right away
+		SET_BIT(RCC->CR, PLLON_BIT);
+		RCC_u8AsyncStage = RCC_ASYNC_WAIT_PLL;
+	}
+	else
+	{
+		// HSI is always running, nothing to wait for: switch right away
+		RCC_u8AsyncSource = RCC_HSI;
+		RCC_u8AsyncStage  = RCC_ASYNC_IDLE;
+		if(RCC_GET_SWS() != RCC_HSI)
+		{
+			RCC->CFGR &= SW_MASK;
+			while(RCC_GET_SWS() != RCC_HSI);
+			RCC_voidUpdateClockTable();
+		}
+	}
+}
+
+
+/**
+ * @brief Advances the bring-up started by RCC_voidStartSysCLK.
+ *
+ * @retval RCC_CLK_PENDING Oscillators are still starting.
+ * @retval RCC_CLK_READY   The requested clock drives SYSCLK.
+ * @retval RCC_CLK_FAILED  The budget ran out, SYSCLK runs from HSI.
+ */
+u8 RCC_u8PollSysCLK(void)
+{
+	u32 Local_u32Elapsed = DWT_GET_CYCLES() - RCC_u32AsyncStart;
+
+	switch(RCC_u8AsyncStage)
+	{
+	case RCC_ASYNC_WAIT_HSE:
+		if(GET_BIT(RCC->CR, HSERDY_BIT) == 1)
+		{
+			RCC_u32StartupCycles[RCC_HSE] = Local_u32Elapsed;
+			if(RCC_u8AsyncSource == RCC_PLL)
+			{
+				// Crystal is stable, the PLL can start locking now
+				SET_BIT(RCC->CR, PLLON_BIT);
+				RCC_u32AsyncStart = DWT_GET_CYCLES();
+				RCC_u8AsyncStage  = RCC_ASYNC_WAIT_PLL;
+				return RCC_CLK_PENDING;
+			}
+			break;
+		}
+		if(Local_u32Elapsed >= RCC_STARTUP_TIMEOUT_CYCLES)
+		{
+			RCC_u32StartupCycles[RCC_HSE] = RCC_STARTUP_TIMEOUT_CYCLES;
+			RCC_u8AsyncStage = RCC_ASYNC_IDLE;
+			RCC_voidFallbackToHSI(1);
+			RCC_voidUpdateClockTable();
+			return RCC_CLK_FAILED;
+		}
+		return RCC_CLK_PENDING;
+
+	case RCC_ASYNC_WAIT_PLL:
+		if(GET_BIT(RCC->CR, PLLRDY_BIT) == 1)
+		{
+			RCC_u32StartupCycles[RCC_PLL] = Local_u32Elapsed;
+			break;
+		}
+		if(Local_u32Elapsed >= RCC_STARTUP_TIMEOUT_CYCLES)
+		{
+			RCC_u32StartupCycles[RCC_PLL] = RCC_STARTUP_TIMEOUT_CYCLES;
+			RCC_u8AsyncStage = RCC_ASYNC_IDLE;
+			// HSE only has to stop when it was started as the PLL entry clock
+			RCC_voidFallbackToHSI((u8)GET_BIT(RCC->CFGR, PLLSRC_BIT));
+			RCC_voidUpdateClockTable();
+			return RCC_CLK_FAILED;
+		}
+		return RCC_CLK_PENDING;
+
+	default:
+		// Nothing in progress: report whether the requested source drives SYSCLK
+		return (RCC_GET_SWS() == RCC_u8AsyncSource) ? RCC_CLK_READY : RCC_CLK_FAILED;
+	}
+
+	// Requested clock is stable: switch SYSCLK to it
+	RCC_u8AsyncStage = RCC_ASYNC_IDLE;
+	RCC->CFGR = (RCC->CFGR & SW_MASK) | RCC_u8AsyncSource;
+	while(RCC_GET_SWS() != RCC_u8AsyncSource);
+
+	// Enable Clock Security System (CSS)
+	SET_BIT(RCC->CR, CSS_BIT);
+
+	RCC_voidUpdateClockTable();
+	return RCC_CLK_READY;
+}
+
+
+/**
+ * @brief Returns how long an oscillator took to become ready the last time it was started.
+ *
+ * @param CLK_Source RCC_HSI, RCC_HSE or RCC_PLL.
+ *
+ * @retval Start-up time in core clock cycles (the budget when it failed), 0 if never measured.
+ */
+u32 RCC_u32GetStartupCycles(u8 CLK_Source)
+{
+	if(CLK_Source > RCC_PLL)
+	{
+		return 0;
+	}
+	return RCC_u32StartupCycles[CLK_Source];
+}
+
+
+/**
+ * @brief Switches the clock tree to a performance level while the application runs.
+ *
+ * @param Copy_u8Level RCC_PERF_LEVEL_HIGH, RCC_PERF_LEVEL_MEDIUM or RCC_PERF_LEVEL_LOW.
+ *
+ * @retval OK    The level is active.
+ * @retval ERROR Invalid level, or the clocks did not start (SYSCLK then runs from HSI).
+ */
+States_Type RCC_enuSetPerformanceLevel(u8 Copy_u8Level)
+{
+	States_Type Local_enuState;
+
+	if(Copy_u8Level >= RCC_PERF_LEVELS_NUM)
+	{
+		return ERROR;
+	}
+	if(Copy_u8Level == RCC_u8PerfLevel)
+	{
+		return OK;
+	}
+
+	// Solve each level only once
+	if(GET_BIT(RCC_u8PerfSolved, Copy_u8Level) == 0)
+	{
+		if(RCC_enuSolveClockTree(&RCC_PerfTargets[Copy_u8Level], &RCC_PerfConfigs[Copy_u8Level]) != OK)
+		{
+			return ERROR;
+		}
+		SET_BIT(RCC_u8PerfSolved, Copy_u8Level);
+	}
+
+	// RCC_enuSetClockConfig marks the segments, the last one runs at the HCLK it leaves
+	DWT_EnableCycleCounter();
+	RCC_u64TransitionNs   = 0;
+	RCC_u32TransitionMark = DWT_GET_CYCLES();
+
+	Local_enuState = RCC_enuSetClockConfig(&RCC_PerfConfigs[Copy_u8Level]);
+
+	RCC_voidTransitionMark(RCC_ClockTable.Bus_Hz[AHB_BUS]);
+	RCC_u32PerfTransitionUs[Copy_u8Level] = (u32)(RCC_u64TransitionNs / 1000UL);
+	RCC_u8PerfLevel = (Local_enuState == OK) ? Copy_u8Level : RCC_PERF_LEVEL_NONE;
+
+	return Local_enuState;
+}
+
+
+/**
+ * @brief Returns the active performance level.
+ *
+ * @retval RCC_PERF_LEVEL_HIGH .. RCC_PERF_LEVEL_LOW, or RCC_PERF_LEVEL_NONE.
+ */
+u8 RCC_u8GetPerformanceLevel(void)
+{
+	return RCC_u8PerfLevel;
+}
+
+
+/**
+ * @brief Returns how long the last switch into a performance level took.
+ *
+ * @param Copy_u8Level RCC_PERF_LEVEL_HIGH, RCC_PERF_LEVEL_MEDIUM or RCC_PERF_LEVEL_LOW.
+ *
+ * @retval Duration of the switch in microseconds, 0 if the level was never entered.
+ */
+u32 RCC_u32GetTransitionUs(u8 Copy_u8Level)
+{
+	if(Copy_u8Level >= RCC_PERF_LEVELS_NUM)
+	{
+		return 0;
+	}
+	return RCC_u32PerfTransitionUs[Copy_u8Level];
+}
+
+
+/*
+ * Function: RCC_voidCSSRebuild
+ * Description: Rebuilds the previous clock tree from HSI after a CSS failure (thread mode only).
+ */
+static void RCC_voidCSSRebuild(void)
+{
+#if RCC_STATIC_CONFIG == 1
+	// No solver in a static build: keep plain HSI, still publish the new frequencies
+	RCC_voidUpdateClockTable();
+#else
+	RCC_ClockTarget_Type Local_Target;
+	RCC_ClockConfig_Type Local_Config;
+
+	// As closely as the HSI/2 PLL entry allows
+	Local_Target.HSE_Hz    = 0;
+	Local_Target.SYSCLK_Hz = (RCC_u8CSSContextValid == 1) ? RCC_CSSClockTable.SYSCLK_Hz        : RCC_SYSCLK_MAX_HZ;
+	Local_Target.HCLK_Hz   = (RCC_u8CSSContextValid == 1) ? RCC_CSSClockTable.Bus_Hz[AHB_BUS]  : 0;
+	Local_Target.PCLK1_Hz  = (RCC_u8CSSContextValid == 1) ? RCC_CSSClockTable.Bus_Hz[APB1_BUS] : 0;
+	Local_Target.PCLK2_Hz  = (RCC_u8CSSContextValid == 1) ? RCC_CSSClockTable.Bus_Hz[APB2_BUS] : 0;
+
+	if(RCC_enuSolveClockTree(&Local_Target, &Local_Config) == OK)
+	{
+		(void)RCC_enuSetClockConfig(&Local_Config);
+	}
+	else
+	{
+		// Keep plain HSI, still publish the new frequencies
+		RCC_voidUpdateClockTable();
+	}
+#endif
+}
+
+
+/**
+ * @brief Handles a Clock Security System failure (HSE clock lost).
+ */
+void RCC_voidCSSHandler(void)
+{
+	if(GET_BIT(RCC->CIR, CSSF_BIT) == 0)
+	{
+		return;
+	}
+
+	// Acknowledge the failure, the hardware already switched SYSCLK to HSI and stopped HSE.
+	// Nothing else here: the NMI can interrupt any RCC_CFGR update or masked section.
+	SET_BIT(RCC->CIR, CSSC_BIT);
+	RCC_u32CSSEvents++;
+	RCC_u8CSSRebuildPending = 1;
+	RCC_u8CSSState = RCC_CSS_DEGRADED;
+}
+
+
+/**
+ * @brief Completes the CSS recovery and retries the crystal. Call it periodically from the main loop.
+ */
+void RCC_voidCSSTask(void)
+{
+	if(RCC_u8CSSState != RCC_CSS_DEGRADED)
+	{
+		return;
+	}
+
+	if(RCC_u8CSSRebuildPending == 1)
+	{
+		// First call after the failure: HSI based clock tree and clock callbacks
+		RCC_u8CSSRebuildPending = 0;
+		RCC_voidCSSRebuild();
+		RCC_u32CSSRetryStart = DWT_GET_CYCLES();
+		return;
+	}
+
+	if(RCC_u8CSSContextValid == 0)
+	{
+		return;
+	}
+
+	if(GET_BIT(RCC->CR, HSEON_BIT) == 0)
+	{
+		// Start a new attempt without waiting for it
+		SET_BIT(RCC->CR, HSEON_BIT);
+		RCC_u32CSSRetryStart = DWT_GET_CYCLES();
+	}
+	else if(GET_BIT(RCC->CR, HSERDY_BIT) == 1)
+	{
+		// Crystal is back: restore the tree that was active at the failure, as after Stop
+		// (the clock table update then sets RCC_CSS_NORMAL). The PLL settings can only be
+		// rewritten once the HSI based replacement PLL is stopped.
+		RCC_voidFallbackToHSI(0);
+		if(RCC_enuRestoreClockContext(&RCC_CSSContext, RCC_STARTUP_TIMEOUT_CYCLES) == OK)
+		{
+			RCC_voidUpdateClockTable();
+		}
+		else
+		{
+			// Fell back to plain HSI and stopped HSE: rebuild on the next call, then retry
+			RCC_u8CSSRebuildPending = 1;
+		}
+	}
+	else if((DWT_GET_CYCLES() - RCC_u32CSSRetryStart) >= RCC_STARTUP_TIMEOUT_CYCLES)
+	{
+		// Still dead: stop it, the next call starts a new attempt
+		CLR_BIT(RCC->CR, HSEON_BIT);
+	}
+}
+
+
+/**
+ * @brief Returns the state of the clock tree regarding CSS failures.
+ *
+ * @retval RCC_CSS_NORMAL or RCC_CSS_DEGRADED.
+ */
+u8 RCC_u8GetCSSState(void)
+{
+	return RCC_u8CSSState;
+}
+
+
+/**
+ * @brief Returns the number of CSS failures handled since reset.
+ *
+ * @retval Number of CSS events.
+ */
+u32 RCC_u32GetCSSEventCount(void)
+{
+	return RCC_u32CSSEvents;
+}
+
+
+#if RCC_CSS_USE_NMI_HANDLER == 1
+/**
+ * @brief Non maskable interrupt handler, the CSS failure is routed to the NMI.
+ */
+void NMI_Handler(void)
+{
+	RCC_voidCSSHandler();
+}
+#endif
+
+
+#if RCC_STATIC_CONFIG == 1
+/**
+ * @brief Applies the clock tree described in RCC_Config.h.
+ */
+void RCC_voidInitStaticClock(void)
+{
+	// Wait states first: the clock only gets faster from the reset state
+	FLASH->ACR = RCC_STATIC_ACR_VALUE;
+
+#if RCC_STATIC_USES_HSE
+	SET_BIT(RCC->CR, HSEON_BIT);
+	while(GET_BIT(RCC->CR, HSERDY_BIT) != 1);		/*Wait until CLK is ready*/
+#endif
+
+	// PLL settings and prescalers in one write, SYSCLK still on HSI
+	RCC->CFGR = RCC_STATIC_CFGR_VALUE;
+
+#if RCC_STATIC_SYSCLK_SOURCE == RCC_PLL
+	SET_BIT(RCC->CR, PLLON_BIT);
+	while(GET_BIT(RCC->CR, PLLRDY_BIT) != 1);		/*Wait until CLK is ready*/
+#endif
+
+	// Select the SYSCLK source
+	RCC->CFGR = RCC_STATIC_CFGR_VALUE | RCC_STATIC_SYSCLK_SOURCE;
+	while(RCC_GET_SWS() != RCC_STATIC_SYSCLK_SOURCE);
+
+#if RCC_STATIC_USES_HSE
+	// Enable Clock Security System (CSS)
+	SET_BIT(RCC->CR, CSS_BIT);
+	RCC_u32HSEFrequency = RCC_STATIC_HSE_HZ;
+#endif
+
+	// Refresh the cached frequencies
+	RCC_voidUpdateClockTable();
+}
+#endif
+
+
+
+/**
+ * @brief Saves the clock tree before Stop mode.
+ *
+ * @param Copy_Context Receives RCC_CR, RCC_CFGR and FLASH_ACR.
+ */
+void RCC_voidSaveClockContext(RCC_ClockContext_Type * Copy_Context)
+{
+	if(Copy_Context == NULL)
+	{
+		return;
+	}
+
+	// The restore is timed with the cycle counter
+	DWT_EnableCycleCounter();
+
+	Copy_Context->CR   = RCC->CR;
+	Copy_Context->CFGR = RCC->CFGR;
+	Copy_Context->ACR  = FLASH->ACR;
+}
+
+
+/**
+ * @brief Restores a saved clock tree after a wake-up from Stop mode.
+ *
+ * @param Copy_Context          Context saved by RCC_voidSaveClockContext.
+ * @param Copy_u32TimeoutCycles Budget per oscillator in core clock cycles.
+ *
+ * @retval OK    The saved tree runs again.
+ * @retval ERROR An oscillator did not start, SYSCLK stays on HSI.
+ */
+States_Type RCC_enuRestoreClockContext(const RCC_ClockContext_Type * Copy_Context, u32 Copy_u32TimeoutCycles)
+{
+	States_Type Local_enuState = OK;
+	u32 Local_u32Start = DWT_GET_CYCLES();
+	u8  Local_u8Source;
+	u8  Local_u8UseHSE;
+	u8  Local_u8PLLFromHSE;
+
+	if(Copy_Context == NULL)
+	{
+		return ERROR;
+	}
+
+	Local_u8Source     = (u8)(Copy_Context->CFGR & 0X03UL);
+	Local_u8UseHSE     = (u8)GET_BIT(Copy_Context->CR, HSEON_BIT);
+	Local_u8PLLFromHSE = (u8)GET_BIT(Copy_Context->CFGR, PLLSRC_BIT);
+
+	// Oscillators first, they are the long part of the wake-up
+	if(Local_u8UseHSE == 1)
+	{
+		SET_BIT(RCC->CR, HSEON_BIT);
+	}
+
+	// PLL settings and prescalers while SYSCLK is on HSI (the PLL is off after Stop):
+	// from here on the core, and DWT, run at HSI / HPRE of the saved tree
+	RCC->CFGR = Copy_Context->CFGR & SW_MASK;
+	RCC_u32RestoreHCLK_Hz = RCC_HSI_FREQUENCY_HZ / RCC_u16GetAHBDivider(Copy_Context->CFGR);
+
+	if((Local_u8Source == RCC_PLL) && (Local_u8PLLFromHSE == 0))
+	{
+		// HSI/2 entry clock: the PLL locks while HSE starts
+		SET_BIT(RCC->CR, PLLON_BIT);
+	}
+
+	// Wait states of the saved SYSCLK are valid for HSI too
+	FLASH->ACR = Copy_Context->ACR;
+
+	if(Local_u8UseHSE == 1)
+	{
+		Local_enuState = RCC_enuWaitReady(RCC_HSE, HSERDY_BIT, Copy_u32TimeoutCycles);
+	}
+
+	if((Local_enuState == OK) && (Local_u8Source == RCC_PLL))
+	{
+		if(Local_u8PLLFromHSE == 1)
+		{
+			SET_BIT(RCC->CR, PLLON_BIT);
+		}
+		Local_enuState = RCC_enuWaitReady(RCC_PLL, PLLRDY_BIT, Copy_u32TimeoutCycles);
+	}
+
+	if(Local_enuState == OK)
+	{
+		RCC->CFGR = Copy_Context->CFGR;
+		while(RCC_GET_SWS() != Local_u8Source);
+
+		if(GET_BIT(Copy_Context->CR, CSS_BIT) == 1)
+		{
+			SET_BIT(RCC->CR, CSS_BIT);
+		}
+		RCC_u32RestoreCycles = DWT_GET_CYCLES() - Local_u32Start;
+	}
+	else
+	{
+		// Dead or slow crystal: keep running from HSI
+		RCC_voidFallbackToHSI(1);
+		RCC_u32RestoreCycles = DWT_GET_CYCLES() - Local_u32Start;
+		RCC_voidUpdateClockTable();
+	}
+
+	return Local_enuState;
+}
+
+
+/**
+ * @brief Returns the duration of the last RCC_enuRestoreClockContext.
+ *
+ * @retval DWT cycles from the start of the restore to the switch to the saved SYSCLK.
+ */
+u32 RCC_u32GetRestoreCycles(void)
+{
+	return RCC_u32RestoreCycles;
+}
+
+
+/**
+ * @brief Returns the duration of the last RCC_enuRestoreClockContext in microseconds.
+ *
+ * @retval RCC_u32GetRestoreCycles converted with the HCLK of the restore (HSI / saved HPRE).
+ */
+u32 RCC_u32GetRestoreUs(void)
+{
+	return (u32)(((u64)RCC_u32RestoreCycles * 1000000UL) / RCC_u32RestoreHCLK_Hz);
+}
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file           : RCC_Config.h
+ * @author         : Ahmed Khaled
+ * @brief          : Static (compile time) clock tree configuration
+ ******************************************************************************/
+
+#ifndef RCC_RCC_CONFIG_H_
+#define RCC_RCC_CONFIG_H_
+
+/*
+ * When RCC_STATIC_CONFIG is 1, RCC_voidInitStaticClock() applies the clock tree below.
+ * Every frequency, bus limit and the flash latency are checked by the preprocessor,
+ * an illegal setup stops the build with #error instead of showing up on hardware.
+ * The CSS recovery then waits on plain HSI instead of an HSI based PLL tree, so the
+ * clock tree solver and RCC_enuSetClockConfig are only linked when the application
+ * calls them. Off by default: the run-time APIs and the HSI-PLL recovery are used.
+ */
+#ifndef RCC_STATIC_CONFIG
+#define RCC_STATIC_CONFIG					0
+#endif
+
+// Frequency of the external crystal (only used when HSE feeds SYSCLK or the PLL)
+#define RCC_STATIC_HSE_HZ					8000000UL
+
+// SYSCLK source: RCC_HSI, RCC_HSE or RCC_PLL
+#define RCC_STATIC_SYSCLK_SOURCE			RCC_PLL
+
+// PLL entry clock: RCC_PLL_SRC_HSI_DIV2, RCC_PLL_SRC_HSE or RCC_PLL_SRC_HSE_DIV2
+#define RCC_STATIC_PLL_SOURCE				RCC_PLL_SRC_HSE
+
+// PLL multiplication factor: 2 .. 16
+#define RCC_STATIC_PLL_MUL					9
+
+// AHB divider: 1, 2, 4, 8, 16, 64, 128, 256 or 512
+#define RCC_STATIC_AHB_DIV					1
+
+// APB1 divider: 1, 2, 4, 8 or 16 (PCLK1 must not exceed 36 MHz)
+#define RCC_STATIC_APB1_DIV					2
+
+// APB2 divider: 1, 2, 4, 8 or 16
+#define RCC_STATIC_APB2_DIV					1
+
+// Flash wait states: leave undefined to use the minimum required by SYSCLK
+// #define RCC_STATIC_FLASH_LATENCY			RCC_FLASH_LATENCY_2
+
+#endif /* RCC_RCC_CONFIG_H_ */
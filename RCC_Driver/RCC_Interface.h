@@ -19,6 +19,42 @@
 #define RCC_HSE				                1			/* RCC_HSE: External High-Speed Clock.*/
 #define RCC_PLL				                2			/* RCC_PLL: Phase-Locked*/
 
+#define RCC_PLL_SRC_HSI_DIV2				0			/* PLL entry clock is HSI divided by 2 */
+#define RCC_PLL_SRC_HSE						1			/* PLL entry clock is HSE */
+#define RCC_PLL_SRC_HSE_DIV2				2			/* PLL entry clock is HSE divided by 2 */
+
+#define RCC_FLASH_LATENCY_0					0			/* 0 wait states, 0 < SYSCLK <= 24 MHz */
+#define RCC_FLASH_LATENCY_1					1			/* 1 wait state, 24 MHz < SYSCLK <= 48 MHz */
+#define RCC_FLASH_LATENCY_2					2			/* 2 wait states, 48 MHz < SYSCLK <= 72 MHz */
+
+
+// Frequency of the external crystal assumed by RCC_voidInitSysCLK(RCC_HSE) and the frequency getters
+#ifndef RCC_HSE_FREQUENCY_HZ
+#define RCC_HSE_FREQUENCY_HZ				8000000UL
+#endif
+
+// Default budget, in core clock cycles, for an oscillator or the PLL to become ready (50 ms at 8 MHz)
+#ifndef RCC_STARTUP_TIMEOUT_CYCLES
+#define RCC_STARTUP_TIMEOUT_CYCLES			400000UL
+#endif
+
+#define RCC_CLK_PENDING						0			/* Clock bring-up still in progress */
+#define RCC_CLK_READY						1			/* Requested clock drives SYSCLK */
+#define RCC_CLK_FAILED						2			/* Budget exhausted, SYSCLK fell back to HSI */
+
+#define RCC_PERF_LEVEL_HIGH					0			/* SYSCLK 72 MHz from PLL, HCLK 72 MHz, PCLK1 36 MHz */
+#define RCC_PERF_LEVEL_MEDIUM				1			/* SYSCLK 72 MHz from PLL, HCLK 36 MHz (prescaler change only) */
+#define RCC_PERF_LEVEL_LOW					2			/* SYSCLK 8 MHz from HSI */
+#define RCC_PERF_LEVEL_NONE					0XFF		/* No performance level selected yet */
+
+// 1: the RCC driver defines NMI_Handler (by default call RCC_voidCSSHandler from your own NMI_Handler)
+#ifndef RCC_CSS_USE_NMI_HANDLER
+#define RCC_CSS_USE_NMI_HANDLER				0
+#endif
+
+#define RCC_CSS_NORMAL						0			/* Clock tree runs as configured */
+#define RCC_CSS_DEGRADED					1			/* HSE failed, running from an HSI based replacement */
+
 
 #define AHB_BUS								0
 #define APB1_BUS							1
@@ -179,6 +215,17 @@
 
 
 
+
+// Build a peripheral mask from one or more peripheral IDs of the same bus
+// e.g. RCC_PERIPH_MASK(GPIOA_APB2) | RCC_PERIPH_MASK(SPI1EN_APB2)
+#define RCC_PERIPH_MASK(PERIPHERAL_ID)		(1UL << (PERIPHERAL_ID))
+#define RCC_PERIPH_MASK2(ID1, ID2)			(RCC_PERIPH_MASK(ID1) | RCC_PERIPH_MASK(ID2))
+#define RCC_PERIPH_MASK3(ID1, ID2, ID3)		(RCC_PERIPH_MASK2(ID1, ID2) | RCC_PERIPH_MASK(ID3))
+#define RCC_PERIPH_MASK4(ID1, ID2, ID3, ID4)	(RCC_PERIPH_MASK2(ID1, ID2) | RCC_PERIPH_MASK2(ID3, ID4))
+
+// Constant initializer of an RCC_PeripheralMask_Type
+#define RCC_PERIPHERAL_MASK_INIT(AHB_MASK, APB1_MASK, APB2_MASK)	{(AHB_MASK), (APB1_MASK), (APB2_MASK)}
+
 /***********************Macros End******************/
 
 /***********************Data Type Start******************/
@@ -190,6 +237,76 @@ typedef struct{
 	u8 APB2_Divide;
 
 }Prescaler_State;
+
+/*
+ * Set of peripherals, one bit per peripheral ID on each bus (see RCC_PERIPH_MASK).
+ */
+typedef struct{
+
+	u32 AHB_Mask;
+	u32 APB1_Mask;
+	u32 APB2_Mask;
+
+}RCC_PeripheralMask_Type;
+
+/*
+ * One register write used to restore the configuration of a peripheral after a reset.
+ */
+typedef struct{
+
+	volatile u32 * Address;
+	u32 Value;
+
+}RCC_RegisterValue_Type;
+
+/*
+ * Requested clock tree. Every frequency is in Hz.
+ *    - HSE_Hz    : Frequency of the external crystal, 0 when no crystal is fitted.
+ *    - SYSCLK_Hz : Wanted system clock (upper bound, the closest reachable value below it is used).
+ *    - HCLK_Hz   : Wanted AHB clock, 0 means equal to SYSCLK.
+ *    - PCLK1_Hz  : Wanted APB1 clock, 0 means as fast as allowed (36 MHz max).
+ *    - PCLK2_Hz  : Wanted APB2 clock, 0 means as fast as allowed (72 MHz max).
+ */
+typedef struct{
+
+	u32 HSE_Hz;
+	u32 SYSCLK_Hz;
+	u32 HCLK_Hz;
+	u32 PCLK1_Hz;
+	u32 PCLK2_Hz;
+
+}RCC_ClockTarget_Type;
+
+/*
+ * Complete clock tree configuration as produced by RCC_enuSolveClockTree
+ * and consumed by RCC_enuSetClockConfig.
+ */
+typedef struct{
+
+	u8 SysClk_Source;			/* RCC_HSI, RCC_HSE or RCC_PLL */
+	u8 PLL_Source;				/* RCC_PLL_SRC_HSI_DIV2, RCC_PLL_SRC_HSE or RCC_PLL_SRC_HSE_DIV2 */
+	u8 PLL_Mul;					/* PLL multiplication factor, 2 .. 16 */
+	u8 Flash_Latency;			/* RCC_FLASH_LATENCY_0 .. RCC_FLASH_LATENCY_2 */
+	Prescaler_State Prescaler;	/* AHB/APB1/APB2 prescaler register codes */
+
+	u32 HSE_Hz;					/* Crystal frequency the configuration was computed for */
+	u32 SYSCLK_Hz;				/* Resulting frequencies */
+	u32 HCLK_Hz;
+	u32 PCLK1_Hz;
+	u32 PCLK2_Hz;
+
+}RCC_ClockConfig_Type;
+
+/*
+ * Clock tree registers saved before a low-power mode (see RCC_voidSaveClockContext).
+ */
+typedef struct{
+
+	u32 CR;						/* Oscillators and CSS that were on */
+	u32 CFGR;					/* SYSCLK source, PLL settings and prescalers */
+	u32 ACR;					/* Flash wait states of the saved SYSCLK */
+
+}RCC_ClockContext_Type;
 /***********************Software Interface Start******************/
 
 /*
@@ -276,6 +393,422 @@ void RCC_voidEnablePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
 void RCC_voidDisablePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
 
 
+/**
+ * @brief Enables the clock of a peripheral with a single atomic store.
+ *
+ * Same as RCC_voidEnablePeripheralClk but the bit is set through the bit-band
+ * alias of the enable register: one store instead of a read-modify-write, so it
+ * can not undo a concurrent change made by an interrupt.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidEnablePeripheralClkAtomic(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
+
+
+/**
+ * @brief Disables the clock of a peripheral with a single atomic store.
+ *
+ * Same as RCC_voidDisablePeripheralClk but through the bit-band alias of the
+ * enable register.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidDisablePeripheralClkAtomic(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
+
+
+/**
+ * @brief Takes a reference on the clock of a peripheral.
+ *
+ * The clock is enabled by the first user and stays enabled until every user called
+ * RCC_voidReleasePeripheralClk. The counter is updated with LDREXB/STREXB and the
+ * enable bit through its bit-band alias, so the main loop and ISRs can both use it.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ *
+ * @note Up to 255 references per peripheral.
+ */
+void RCC_voidAcquirePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
+
+
+/**
+ * @brief Drops a reference on the clock of a peripheral.
+ *
+ * The clock is disabled when the last reference is released.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID (e.g. GPIOA_APB2, CAN1EN_APB1).
+ */
+void RCC_voidReleasePeripheralClk(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
+
+
+/**
+ * @brief Returns the number of references held on the clock of a peripheral.
+ *
+ * @param Copy_u8BusID        AHB_BUS, APB1_BUS or APB2_BUS.
+ * @param Copy_u8PeripheralID Peripheral ID.
+ *
+ * @retval Reference count, 0 for an invalid bus or peripheral ID.
+ */
+u8 RCC_u8GetPeripheralRefCount(u8 Copy_u8BusID, u8 Copy_u8PeripheralID);
+
+
+/**
+ * @brief Reads the set of peripherals whose clock is currently enabled.
+ *
+ * @param Copy_Mask Pointer to the structure that receives AHBENR, APB1ENR and APB2ENR.
+ */
+void RCC_voidGetEnabledPeripherals(RCC_PeripheralMask_Type * Copy_Mask);
+
+
+/**
+ * @brief Enables the clocks of several peripherals at once.
+ *
+ * Each of AHBENR, APB1ENR and APB2ENR is accessed at most once (one read-modify-write),
+ * and not at all when its mask is 0.
+ *
+ * @param Copy_Mask Pointer to the peripherals to enable, built with RCC_PERIPH_MASK
+ *                  (e.g. RCC_PERIPHERAL_MASK_INIT(0, RCC_PERIPH_MASK(USART2EN_APB1),
+ *                  RCC_PERIPH_MASK2(GPIOA_APB2, AFIOEN_APB))).
+ */
+void RCC_voidEnablePeripheralMask(const RCC_PeripheralMask_Type * Copy_Mask);
+
+
+/**
+ * @brief Disables the clocks of several peripherals at once.
+ *
+ * Each of AHBENR, APB1ENR and APB2ENR is accessed at most once (one read-modify-write),
+ * and not at all when its mask is 0.
+ *
+ * @param Copy_Mask Pointer to the peripherals to disable.
+ */
+void RCC_voidDisablePeripheralMask(const RCC_PeripheralMask_Type * Copy_Mask);
+
+
+/**
+ * @brief Resets several APB peripherals at once.
+ *
+ * The reset bits of APB1RSTR and APB2RSTR are set with one write per register and
+ * released with one more. The reset bits are at the same positions as the enable
+ * bits, so the *_APB1 and *_APB2 peripheral IDs (and RCC_PERIPH_MASK) are used.
+ *
+ * @param Copy_Mask Pointer to the peripherals to reset (AHB_Mask is ignored: the
+ *                  AHB peripherals of this device have no reset bit).
+ *
+ * @note The clock enable bits are not changed.
+ */
+void RCC_voidResetPeripheralMask(const RCC_PeripheralMask_Type * Copy_Mask);
+
+
+/**
+ * @brief Recovers wedged peripherals without a system reset.
+ *
+ * The peripherals are reset with RCC_voidResetPeripheralMask, then the saved register
+ * values are written back in order, so the peripheral is ready to use again.
+ *
+ * @param Copy_Mask          Pointer to the peripherals to reset.
+ * @param Copy_Restore       Register values to write after the reset (may be NULL when Copy_u8RestoreCount is 0).
+ * @param Copy_u8RestoreCount Number of entries in Copy_Restore.
+ * @param Copy_pu32Cycles    Receives the duration of the recovery in DWT cycles (may be NULL).
+ *
+ * @retval OK    The peripherals were reset and reconfigured.
+ * @retval ERROR Invalid argument, nothing was done.
+ */
+States_Type RCC_enuRecoverPeripheral(const RCC_PeripheralMask_Type * Copy_Mask, const RCC_RegisterValue_Type * Copy_Restore,
+									 u8 Copy_u8RestoreCount, u32 * Copy_pu32Cycles);
+
+
+/**
+ * @brief Computes a legal clock tree configuration for the requested frequencies.
+ *
+ * This function is a pure function: it does not access any register, so it can be
+ * called before the clocks are touched (or compiled and run on a host machine).
+ * It selects the SYSCLK source (HSI, HSE or PLL), the PLL entry clock and multiplier,
+ * the AHB/APB1/APB2 prescalers and the flash wait states.
+ *
+ * @param Target Pointer to the requested frequencies.
+ * @param Config Pointer to the structure that receives the computed configuration.
+ *
+ * @note SYSCLK is never higher than Target->SYSCLK_Hz; when it can not be matched
+ *       exactly the highest reachable frequency below it is used. Each bus clock is
+ *       the highest value that does not exceed both the request and the bus limit.
+ *
+ * @retval OK    A configuration was found and written to Config.
+ * @retval ERROR The request can not be satisfied (or a NULL pointer was passed).
+ */
+States_Type RCC_enuSolveClockTree(const RCC_ClockTarget_Type * Target, RCC_ClockConfig_Type * Config);
+
+
+/**
+ * @brief Applies a clock tree configuration computed by RCC_enuSolveClockTree.
+ *
+ * The configuration is applied in a safe order: the flash wait states are raised
+ * first, SYSCLK runs from HSI while the PLL is reprogrammed, the prescalers are set
+ * before the new source is selected, and the wait states are lowered last. When the
+ * source changes, the PLL and HSE are stopped if the new tree does not use them.
+ *
+ * @param Config Pointer to the configuration to apply.
+ *
+ * @retval OK    The configuration is active.
+ * @retval ERROR Config is NULL, or HSE/PLL did not become ready within
+ *               RCC_STARTUP_TIMEOUT_CYCLES (SYSCLK then runs from HSI).
+ */
+States_Type RCC_enuSetClockConfig(const RCC_ClockConfig_Type * Config);
+
+
+/**
+ * @brief Solves and applies the clock tree for the requested frequencies.
+ *
+ * @param Target Pointer to the requested frequencies (e.g. HSE 8 MHz, SYSCLK 72 MHz,
+ *               PCLK1 36 MHz, PCLK2 72 MHz).
+ *
+ * @retval OK    The requested clock tree is active.
+ * @retval ERROR The request can not be satisfied, the clocks are not changed.
+ */
+States_Type RCC_enuInitClockTree(const RCC_ClockTarget_Type * Target);
+
+
+
+/**
+ * @brief Initializes the system clock like RCC_voidInitSysCLK but within a bounded time.
+ *
+ * Each ready flag (HSE, PLL) is polled against a budget measured with the DWT cycle
+ * counter. When the budget runs out the failing oscillator is turned off and SYSCLK
+ * stays on (or falls back to) HSI, so boot never hangs on a slow or dead crystal.
+ *
+ * @param CLK_Source            RCC_HSI, RCC_HSE or RCC_PLL (the PLL uses the entry clock
+ *                              and multiplier already programmed in RCC_CFGR).
+ * @param Copy_u32TimeoutCycles Budget per oscillator in core clock cycles
+ *                              (e.g. RCC_STARTUP_TIMEOUT_CYCLES).
+ *
+ * @retval OK    The requested clock drives SYSCLK.
+ * @retval ERROR The budget ran out, SYSCLK runs from HSI.
+ */
+States_Type RCC_enuInitSysCLKTimeout(u8 CLK_Source, u32 Copy_u32TimeoutCycles);
+
+
+/**
+ * @brief Starts the bring-up of a system clock without waiting for it.
+ *
+ * The oscillators are switched on and the function returns immediately, so the
+ * application can run other initialization while RCC_u8PollSysCLK is called
+ * until the clock is ready. The budget per oscillator is RCC_STARTUP_TIMEOUT_CYCLES.
+ *
+ * @param CLK_Source RCC_HSI, RCC_HSE or RCC_PLL.
+ */
+void RCC_voidStartSysCLK(u8 CLK_Source);
+
+
+/**
+ * @brief Advances the bring-up started by RCC_voidStartSysCLK.
+ *
+ * @retval RCC_CLK_PENDING Oscillators are still starting.
+ * @retval RCC_CLK_READY   The requested clock drives SYSCLK.
+ * @retval RCC_CLK_FAILED  The budget ran out, SYSCLK runs from HSI.
+ */
+u8 RCC_u8PollSysCLK(void);
+
+
+/**
+ * @brief Returns how long an oscillator took to become ready the last time it was started.
+ *
+ * @param CLK_Source RCC_HSI, RCC_HSE or RCC_PLL.
+ *
+ * @retval Start-up time in core clock cycles (the budget when it failed), 0 if never measured.
+ */
+u32 RCC_u32GetStartupCycles(u8 CLK_Source);
+
+
+/**
+ * @brief Switches the clock tree to a performance level while the application runs.
+ *
+ * The configuration of each level is solved once and cached. The switch goes through
+ * RCC_enuSetClockConfig: flash wait states are raised before and lowered after the
+ * clock change, the bus prescalers are ordered so no bus exceeds its limit, and the
+ * registered clock change callbacks are called so drivers can re-tune their dividers.
+ * The duration of the switch is measured with the DWT cycle counter (RCC_u32GetTransitionUs).
+ *
+ * @param Copy_u8Level RCC_PERF_LEVEL_HIGH, RCC_PERF_LEVEL_MEDIUM or RCC_PERF_LEVEL_LOW.
+ *
+ * @retval OK    The level is active.
+ * @retval ERROR Invalid level, or the clocks did not start (SYSCLK then runs from HSI).
+ */
+States_Type RCC_enuSetPerformanceLevel(u8 Copy_u8Level);
+
+
+/**
+ * @brief Returns the active performance level.
+ *
+ * @retval RCC_PERF_LEVEL_HIGH .. RCC_PERF_LEVEL_LOW, or RCC_PERF_LEVEL_NONE when the
+ *         clocks were configured without RCC_enuSetPerformanceLevel.
+ */
+u8 RCC_u8GetPerformanceLevel(void);
+
+
+/**
+ * @brief Returns how long the last switch into a performance level took.
+ *
+ * @param Copy_u8Level RCC_PERF_LEVEL_HIGH, RCC_PERF_LEVEL_MEDIUM or RCC_PERF_LEVEL_LOW.
+ *
+ * @retval Duration of the switch in microseconds, 0 if the level was never entered. The DWT
+ *         counter runs at HCLK, which changes during the switch: the segments before and
+ *         after each change are converted with the HCLK that ran during them.
+ */
+u32 RCC_u32GetTransitionUs(u8 Copy_u8Level);
+
+
+/**
+ * @brief Handles a Clock Security System failure (HSE clock lost).
+ *
+ * Clears the CSS flag in RCC_CIR, counts the event and marks the clock tree degraded.
+ * The hardware already runs SYSCLK from HSI; the HSI based replacement tree and the
+ * clock change callbacks are left to RCC_voidCSSTask, since the NMI can interrupt any
+ * RCC_CFGR update or BASEPRI masked section.
+ *
+ * @note Call it from NMI_Handler (defined by the driver when RCC_CSS_USE_NMI_HANDLER is 1).
+ */
+void RCC_voidCSSHandler(void);
+
+
+/**
+ * @brief Completes the CSS recovery and retries the crystal. Call it periodically from the main loop.
+ *
+ * The first call after a failure rebuilds an HSI based PLL configuration as close as
+ * possible to the SYSCLK/HCLK/PCLK1/PCLK2 frequencies that were active and calls the
+ * registered clock change callbacks (with RCC_STATIC_CONFIG 1 there is no solver and
+ * SYSCLK stays on plain HSI). Until then the cached frequencies are stale.
+ * While degraded, HSE is then started without blocking. Once it is ready the crystal
+ * based tree that was active before the failure is restored from its register values,
+ * whichever API had set it up (RCC_enuInitClockTree, performance levels, static tree...).
+ * A crystal that does not become ready within RCC_STARTUP_TIMEOUT_CYCLES is switched off
+ * and tried again on a later call.
+ */
+void RCC_voidCSSTask(void);
+
+
+/**
+ * @brief Returns the state of the clock tree regarding CSS failures.
+ *
+ * @retval RCC_CSS_NORMAL or RCC_CSS_DEGRADED.
+ */
+u8 RCC_u8GetCSSState(void);
+
+
+/**
+ * @brief Returns the number of CSS failures handled since reset.
+ *
+ * @retval Number of CSS events.
+ */
+u32 RCC_u32GetCSSEventCount(void);
+
+
+/**
+ * @brief Returns the current SYSCLK frequency in Hz.
+ *
+ * The value is read from a table that the RCC driver refreshes each time it changes
+ * the clock tree, so this call never touches RCC_CFGR.
+ *
+ * @retval SYSCLK frequency in Hz.
+ */
+u32 RCC_u32GetSysClockHz(void);
+
+
+/**
+ * @brief Returns the current clock frequency of a bus in Hz.
+ *
+ * @param Copy_u8BusID The bus: AHB_BUS (HCLK), APB1_BUS (PCLK1) or APB2_BUS (PCLK2).
+ *
+ * @retval Bus frequency in Hz, 0 for an invalid bus ID.
+ */
+u32 RCC_u32GetBusClockHz(u8 Copy_u8BusID);
+
+
+/**
+ * @brief Returns the clock frequency fed to the timers of a bus in Hz.
+ *
+ * When the APB prescaler is not 1 the timers run at twice the APB clock.
+ *
+ * @param Copy_u8BusID The bus: APB1_BUS (TIM2..TIM7) or APB2_BUS (TIM1, TIM8).
+ *                     AHB_BUS returns HCLK.
+ *
+ * @retval Timer clock frequency in Hz, 0 for an invalid bus ID.
+ */
+u32 RCC_u32GetTimerClockHz(u8 Copy_u8BusID);
+
+
+/**
+ * @brief Registers a function to be called each time the clock tree changes.
+ *
+ * Dependent drivers (USART, timers, ...) use it to recompute their dividers. The
+ * callback is called after the new frequencies are available from the getters.
+ *
+ * @param Copy_pvCallback Function to call on each clock change.
+ *
+ * @retval OK    The callback is registered.
+ * @retval ERROR NULL callback or no free slot (RCC_MAX_CLOCK_CALLBACKS reached).
+ */
+States_Type RCC_enuRegisterClockCallback(void (*Copy_pvCallback)(void));
+
+
+
+/**
+ * @brief Applies the clock tree described in RCC_Config.h.
+ *
+ * All frequencies, bus limits and the flash latency are checked at compile time and
+ * the register values are precomputed, so this is a short fixed write sequence with
+ * no solver or switch at run time. Only available when RCC_STATIC_CONFIG is 1.
+ *
+ * @note Must be called from the reset clock state (SYSCLK on HSI, PLL off).
+ */
+void RCC_voidInitStaticClock(void);
+
+
+/**
+ * @brief Saves the clock tree before Stop mode.
+ *
+ * @param Copy_Context Receives RCC_CR, RCC_CFGR and FLASH_ACR.
+ */
+void RCC_voidSaveClockContext(RCC_ClockContext_Type * Copy_Context);
+
+
+/**
+ * @brief Restores a saved clock tree after a wake-up from Stop mode (SYSCLK on HSI, PLL and HSE off).
+ *
+ * HSE is started first. A PLL fed by HSI/2 is started at the same time, a PLL fed by HSE right
+ * after HSERDY. The PLL settings, prescalers and flash wait states are written while the
+ * oscillators start up, so only the final source switch waits. The cached frequencies are
+ * those of the saved tree, the clock change callbacks are not called.
+ *
+ * @param Copy_Context          Context saved by RCC_voidSaveClockContext.
+ * @param Copy_u32TimeoutCycles Budget per oscillator in core clock cycles.
+ *
+ * @retval OK    The saved tree runs again.
+ * @retval ERROR An oscillator did not start, SYSCLK stays on HSI (callbacks are called).
+ */
+States_Type RCC_enuRestoreClockContext(const RCC_ClockContext_Type * Copy_Context, u32 Copy_u32TimeoutCycles);
+
+
+/**
+ * @brief Returns the duration of the last RCC_enuRestoreClockContext.
+ *
+ * @retval DWT cycles from the start of the restore to the switch to the saved SYSCLK,
+ *         counted while the core runs from HSI divided by the saved AHB prescaler
+ *         (the prescalers are written before the oscillators are waited for).
+ */
+u32 RCC_u32GetRestoreCycles(void);
+
+
+/**
+ * @brief Returns the duration of the last RCC_enuRestoreClockContext in microseconds.
+ *
+ * @retval RCC_u32GetRestoreCycles converted with the HCLK in effect during the restore
+ *         (HSI / saved HPRE), not with the HSI frequency.
+ */
+u32 RCC_u32GetRestoreUs(void);
+
+
 
 /***********************Software Interface End******************/
 
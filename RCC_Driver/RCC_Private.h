@@ -8,6 +8,205 @@
 #ifndef RCC_RCC_PRIVATE_H_
 #define RCC_RCC_PRIVATE_H_
 
+/***********************Clock Tree Limits Start******************/
+// Frequency of the internal RC oscillator
+#define RCC_HSI_FREQUENCY_HZ				8000000UL
 
+// Maximum frequencies allowed on SYSCLK/HCLK and on the two APB buses
+#define RCC_SYSCLK_MAX_HZ					72000000UL
+#define RCC_PCLK1_MAX_HZ					36000000UL
+#define RCC_PCLK2_MAX_HZ					72000000UL
+
+// Allowed range of the external crystal
+#define RCC_HSE_MIN_HZ						4000000UL
+#define RCC_HSE_MAX_HZ						16000000UL
+
+// Allowed range of the PLL output and of the PLL multiplication factor
+#define RCC_PLL_OUT_MIN_HZ					16000000UL
+#define RCC_PLL_MUL_MIN						2U
+#define RCC_PLL_MUL_MAX						16U
+
+// Highest SYSCLK allowed for 0 and 1 flash wait states (above that 2 are needed)
+#define RCC_FLASH_0WS_MAX_HZ				24000000UL
+#define RCC_FLASH_1WS_MAX_HZ				48000000UL
+/***********************Clock Tree Limits End********************/
+
+/***********************Private Macros Start******************/
+// Number of entries in the AHB and APB divider tables
+#define RCC_AHB_DIVIDERS_NUM				9U
+#define RCC_APB_DIVIDERS_NUM				5U
+
+// Read the SWS field of RCC_CFGR (the clock source currently driving SYSCLK)
+#define RCC_GET_SWS()						(((RCC->CFGR) >> SWS_POS) & 0X03UL)
+
+// Maximum number of clock change callbacks that can be registered
+#define RCC_MAX_CLOCK_CALLBACKS				4U
+
+// Number of buses and of peripheral bits per bus tracked by the clock reference counters
+#define RCC_BUSES_NUM						3U
+#define RCC_PERIPHERALS_PER_BUS				32U
+
+// Number of performance levels handled by RCC_enuSetPerformanceLevel
+#define RCC_PERF_LEVELS_NUM					3U
+
+// Stages of the asynchronous clock bring-up
+#define RCC_ASYNC_IDLE						0U
+#define RCC_ASYNC_WAIT_HSE					1U
+#define RCC_ASYNC_WAIT_PLL					2U
+/***********************Private Macros End********************/
+
+/***********************Private Data Type Start******************/
+/*
+ * Cached frequencies of the clock tree, indexed by AHB_BUS, APB1_BUS and APB2_BUS.
+ * Timer_Hz holds the timer kernel clocks (PCLKx, or 2 x PCLKx when the APB prescaler is not 1).
+ */
+typedef struct{
+
+	u32 SYSCLK_Hz;
+	u32 Bus_Hz[3];
+	u32 Timer_Hz[3];
+
+}RCC_ClockFreq_Type;
+/***********************Private Data Type End********************/
+
+/***********************Static Configuration Start******************/
+#if RCC_STATIC_CONFIG == 1
+
+// PLL entry clock
+#if RCC_STATIC_PLL_SOURCE == RCC_PLL_SRC_HSI_DIV2
+#define RCC_STATIC_PLL_IN_HZ				(RCC_HSI_FREQUENCY_HZ / 2)
+#define RCC_STATIC_PLL_CFG_BITS				0UL
+#elif RCC_STATIC_PLL_SOURCE == RCC_PLL_SRC_HSE
+#define RCC_STATIC_PLL_IN_HZ				(RCC_STATIC_HSE_HZ)
+#define RCC_STATIC_PLL_CFG_BITS				(1UL << PLLSRC_BIT)
+#elif RCC_STATIC_PLL_SOURCE == RCC_PLL_SRC_HSE_DIV2
+#define RCC_STATIC_PLL_IN_HZ				(RCC_STATIC_HSE_HZ / 2)
+#define RCC_STATIC_PLL_CFG_BITS				((1UL << PLLSRC_BIT) | (1UL << PLLXTPRE_BIT))
+#else
+#error "RCC_STATIC_PLL_SOURCE must be RCC_PLL_SRC_HSI_DIV2, RCC_PLL_SRC_HSE or RCC_PLL_SRC_HSE_DIV2"
+#endif
+
+// SYSCLK and whether the crystal has to run
+#if RCC_STATIC_SYSCLK_SOURCE == RCC_HSI
+#define RCC_STATIC_SYSCLK_HZ				RCC_HSI_FREQUENCY_HZ
+#define RCC_STATIC_USES_HSE					0
+#elif RCC_STATIC_SYSCLK_SOURCE == RCC_HSE
+#define RCC_STATIC_SYSCLK_HZ				RCC_STATIC_HSE_HZ
+#define RCC_STATIC_USES_HSE					1
+#elif RCC_STATIC_SYSCLK_SOURCE == RCC_PLL
+#if (RCC_STATIC_PLL_MUL < RCC_PLL_MUL_MIN) || (RCC_STATIC_PLL_MUL > RCC_PLL_MUL_MAX)
+#error "RCC_STATIC_PLL_MUL must be in 2 .. 16"
+#endif
+#define RCC_STATIC_SYSCLK_HZ				(RCC_STATIC_PLL_IN_HZ * RCC_STATIC_PLL_MUL)
+#define RCC_STATIC_USES_HSE					(RCC_STATIC_PLL_SOURCE != RCC_PLL_SRC_HSI_DIV2)
+#if RCC_STATIC_SYSCLK_HZ < RCC_PLL_OUT_MIN_HZ
+#error "PLL output is below 16 MHz"
+#endif
+#else
+#error "RCC_STATIC_SYSCLK_SOURCE must be RCC_HSI, RCC_HSE or RCC_PLL"
+#endif
+
+#if RCC_STATIC_USES_HSE && ((RCC_STATIC_HSE_HZ < RCC_HSE_MIN_HZ) || (RCC_STATIC_HSE_HZ > RCC_HSE_MAX_HZ))
+#error "RCC_STATIC_HSE_HZ must be in 4 .. 16 MHz"
+#endif
+
+#if RCC_STATIC_SYSCLK_HZ > RCC_SYSCLK_MAX_HZ
+#error "SYSCLK exceeds 72 MHz"
+#endif
+
+// AHB prescaler code
+#if   RCC_STATIC_AHB_DIV == 1
+#define RCC_STATIC_HPRE					AHB_PRESCALER_NOT_DIVIDED
+#elif RCC_STATIC_AHB_DIV == 2
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_2
+#elif RCC_STATIC_AHB_DIV == 4
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_4
+#elif RCC_STATIC_AHB_DIV == 8
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_8
+#elif RCC_STATIC_AHB_DIV == 16
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_16
+#elif RCC_STATIC_AHB_DIV == 64
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_64
+#elif RCC_STATIC_AHB_DIV == 128
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_128
+#elif RCC_STATIC_AHB_DIV == 256
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_256
+#elif RCC_STATIC_AHB_DIV == 512
+#define RCC_STATIC_HPRE					AHB_PRESCALER_DIVIDED_BY_512
+#else
+#error "RCC_STATIC_AHB_DIV must be 1, 2, 4, 8, 16, 64, 128, 256 or 512"
+#endif
+
+// APB1 prescaler code
+#if   RCC_STATIC_APB1_DIV == 1
+#define RCC_STATIC_PPRE1					APB1_PRESCALER_DIV_NONE
+#elif RCC_STATIC_APB1_DIV == 2
+#define RCC_STATIC_PPRE1					APB1_PRESCALER_DIV_2
+#elif RCC_STATIC_APB1_DIV == 4
+#define RCC_STATIC_PPRE1					APB1_PRESCALER_DIV_4
+#elif RCC_STATIC_APB1_DIV == 8
+#define RCC_STATIC_PPRE1					APB1_PRESCALER_DIV_8
+#elif RCC_STATIC_APB1_DIV == 16
+#define RCC_STATIC_PPRE1					APB1_PRESCALER_DIV_16
+#else
+#error "RCC_STATIC_APB1_DIV must be 1, 2, 4, 8 or 16"
+#endif
+
+// APB2 prescaler code
+#if   RCC_STATIC_APB2_DIV == 1
+#define RCC_STATIC_PPRE2					APB2_PRESCALER_NOT_DIVIDED
+#elif RCC_STATIC_APB2_DIV == 2
+#define RCC_STATIC_PPRE2					APB2_PRESCALER_DIVIDED_BY_2
+#elif RCC_STATIC_APB2_DIV == 4
+#define RCC_STATIC_PPRE2					APB2_PRESCALER_DIVIDED_BY_4
+#elif RCC_STATIC_APB2_DIV == 8
+#define RCC_STATIC_PPRE2					APB2_PRESCALER_DIVIDED_BY_8
+#elif RCC_STATIC_APB2_DIV == 16
+#define RCC_STATIC_PPRE2					APB2_PRESCALER_DIVIDED_BY_16
+#else
+#error "RCC_STATIC_APB2_DIV must be 1, 2, 4, 8 or 16"
+#endif
+
+// Bus limits
+#define RCC_STATIC_HCLK_HZ					(RCC_STATIC_SYSCLK_HZ / RCC_STATIC_AHB_DIV)
+#define RCC_STATIC_PCLK1_HZ					(RCC_STATIC_HCLK_HZ / RCC_STATIC_APB1_DIV)
+#define RCC_STATIC_PCLK2_HZ					(RCC_STATIC_HCLK_HZ / RCC_STATIC_APB2_DIV)
+
+#if RCC_STATIC_PCLK1_HZ > RCC_PCLK1_MAX_HZ
+#error "PCLK1 exceeds 36 MHz, increase RCC_STATIC_APB1_DIV"
+#endif
+#if RCC_STATIC_PCLK2_HZ > RCC_PCLK2_MAX_HZ
+#error "PCLK2 exceeds 72 MHz"
+#endif
+
+// Flash wait states required by SYSCLK
+#if RCC_STATIC_SYSCLK_HZ <= RCC_FLASH_0WS_MAX_HZ
+#define RCC_STATIC_MIN_LATENCY				RCC_FLASH_LATENCY_0
+#elif RCC_STATIC_SYSCLK_HZ <= RCC_FLASH_1WS_MAX_HZ
+#define RCC_STATIC_MIN_LATENCY				RCC_FLASH_LATENCY_1
+#else
+#define RCC_STATIC_MIN_LATENCY				RCC_FLASH_LATENCY_2
+#endif
+
+#ifndef RCC_STATIC_FLASH_LATENCY
+#define RCC_STATIC_FLASH_LATENCY			RCC_STATIC_MIN_LATENCY
+#endif
+#if (RCC_STATIC_FLASH_LATENCY < RCC_STATIC_MIN_LATENCY) || (RCC_STATIC_FLASH_LATENCY > RCC_FLASH_LATENCY_2)
+#error "RCC_STATIC_FLASH_LATENCY is too low for SYSCLK"
+#endif
+
+// Precomputed register values (SW is written last, on its own)
+#if RCC_STATIC_SYSCLK_SOURCE == RCC_PLL
+#define RCC_STATIC_PLL_BITS					(RCC_STATIC_PLL_CFG_BITS | ((u32)(RCC_STATIC_PLL_MUL - RCC_PLL_MUL_MIN) << PLLMUL_POS))
+#else
+#define RCC_STATIC_PLL_BITS					0UL
+#endif
+
+#define RCC_STATIC_CFGR_VALUE				(RCC_STATIC_PLL_BITS | ((u32)RCC_STATIC_PPRE2 << PPRE2_POS) | \
+											 ((u32)RCC_STATIC_PPRE1 << PPRE1_POS) | ((u32)RCC_STATIC_HPRE << HPRE_POS))
+#define RCC_STATIC_ACR_VALUE				((1UL << PRFTBE_BIT) | (u32)RCC_STATIC_FLASH_LATENCY)
+
+#endif
+/***********************Static Configuration End********************/
 
 #endif /* RCC_RCC_PRIVATE_H_ */
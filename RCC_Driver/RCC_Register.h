@@ -26,6 +26,18 @@ typedef struct {
     volatile u32 BDCR;        // Offset: 0x20 - Backup Domain Control Register
     volatile u32 CSR;         // Offset: 0x24 - Control/Status Register
 } RCC_TypeDef;
+
+typedef struct {
+    volatile u32 ACR;         // Offset: 0x00 - Flash Access Control Register
+    volatile u32 KEYR;        // Offset: 0x04 - FPEC Key Register
+    volatile u32 OPTKEYR;     // Offset: 0x08 - Flash OPTKEY Register
+    volatile u32 SR;          // Offset: 0x0C - Flash Status Register
+    volatile u32 CR;          // Offset: 0x10 - Flash Control Register
+    volatile u32 AR;          // Offset: 0x14 - Flash Address Register
+    volatile u32 RESERVED;    // Offset: 0x18 - Reserved
+    volatile u32 OBR;         // Offset: 0x1C - Option Byte Register
+    volatile u32 WRPR;        // Offset: 0x20 - Write Protection Register
+} FLASH_TypeDef;
 /***********************Data Type End******************/
 
 /***********************Macros Start******************/
@@ -35,6 +47,10 @@ typedef struct {
 // RCC peripheral instance
 #define RCC							((RCC_TypeDef *) RCC_BASE)
 
+// Flash interface base address and instance (needed for the wait states of the clock tree)
+#define FLASH_BASE					0X40022000UL
+#define FLASH						((FLASH_TypeDef *) FLASH_BASE)
+
 // Bit positions for various control bits related to High-Speed External (HSE) and High-Speed Internal (HSI) oscillators
 #define HSEON_BIT					16U
 #define HSERDY_BIT					17U
@@ -48,10 +64,33 @@ typedef struct {
 // Bit position for control bit related to Clock Security System (CSS)
 #define CSS_BIT						19
 
+// Bit positions of the Clock Security System flag and its clear bit (RCC_CIR)
+#define CSSF_BIT					7U
+#define CSSC_BIT					23U
+
 // Bit positions for the SW (System Clock Switch) control bits
 #define SW0_BIT							0
 #define SW1_BIT							1U
 
+// Position of the SWS (System Clock Switch Status) field in RCC_CFGR[3:2]
+#define SWS_POS						2U
+
+// Positions of the HPRE, PPRE1 and PPRE2 prescaler fields in RCC_CFGR
+#define HPRE_POS					4U
+#define PPRE1_POS					8U
+#define PPRE2_POS					11U
+
+// Bit positions for the PLL entry clock source and the HSE divider for PLL entry
+#define PLLSRC_BIT					16U
+#define PLLXTPRE_BIT				17U
+
+// Position of the PLLMUL (PLL multiplication factor) field in RCC_CFGR[21:18]
+#define PLLMUL_POS					18U
+
+// Bit positions in the FLASH_ACR register
+#define PRFTBE_BIT					4U
+#define PRFTBS_BIT					5U
+
 //RCC Masks
 
 // Mask to clear the bits responsible for APB1 prescaler in the RCC_CFGR register
@@ -63,6 +102,15 @@ typedef struct {
 // Mask to clear the bits responsible for AHB prescaler in the RCC_CFGR register
 #define AHP_PRE_MASK                 0XFFFFFF0FUL
 
+// Mask to clear the SW (System Clock Switch) bits in the RCC_CFGR register
+#define SW_MASK                      0XFFFFFFFCUL
+
+// Mask to clear the PLLSRC, PLLXTPRE and PLLMUL bits in the RCC_CFGR register
+#define PLL_CFG_MASK                 0XFFC0FFFFUL
+
+// Mask to clear the LATENCY bits in the FLASH_ACR register
+#define FLASH_LATENCY_MASK           0XFFFFFFF8UL
+
 
 /***********************Macros End******************/
 
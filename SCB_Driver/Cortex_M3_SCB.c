@@ -7,6 +7,24 @@
 
 
 #include "SCB/Cortex_M3_SCB.h"
+#include "Libraries/CORE_INTRINSICS.h"
+#include "Libraries/BIT_MATH.h"
+
+
+/*
+ * Copy of AIRCR PRIGROUP, kept so the priority APIs do not read AIRCR on every call. It is
+ * seeded from AIRCR on first use (a grouping set by startup code or a bootloader is kept).
+ */
+#define SCB_PRIORITY_GROUP_UNKNOWN			0XFFUL
+static u32 SCB_u32PriorityGroup = SCB_PRIORITY_GROUP_UNKNOWN;
+
+/* Vector table in SRAM, used once SCB_RelocateVectorTable switched VTOR to it */
+static volatile u32 SCB_u32RamVectorTable[SCB_VECTOR_TABLE_SIZE] __attribute__((aligned(SCB_VECTOR_TABLE_ALIGN)));
+
+/* Idle governor */
+static SCB_TimeSource_Type SCB_IdleTimeSource = NULL;
+static SCB_WorkCheck_Type  SCB_IdleWorkCheck  = NULL;
+static SCB_IdleStats_Type  SCB_IdleStats[SCB_IDLE_MODES];
 
 
 /**
@@ -42,6 +60,9 @@ void SCB_SetPriorityGrouping(u32 PriorityGroup)
 	 * This is where the actual configuration of the priority grouping takes place.
 	 */
 	SCB->AIRCR = Register_Value;
+
+	/* Keep the active grouping for SCB_GetPriorityGrouping and the NVIC priority encoding */
+	SCB_u32PriorityGroup = PriorityGroupTemp;
 }
 
 
@@ -52,12 +73,339 @@ void SCB_SetPriorityGrouping(u32 PriorityGroup)
  *  brief 	 	Get Priority Grouping
  *  details		Get the priority grouping field in the System Control Block (SCB).
  * 	return		Priority grouping field (SCB->AIRCR [10:8] PRIGROUP field).
+ *  note		AIRCR is only read by the first call, then the value cached by it or by
+ *  			SCB_SetPriorityGrouping is returned.
  */
 
 u32 SCB_GetPriorityGrouping(void)
 {
-    u32 Register_Val = PRIORITY_GROUP_MASK;  				// Initial value with a mask that covers bits [10:8] in case the configuration changes.
-    Register_Val &= SCB->AIRCR; 							// Perform a bitwise AND operation to isolate the relevant bits.
-    return (Register_Val >> SCB_AIRCR_PRIGROUP_POS); 		// Right-shift to obtain the actual priority grouping field.
+	if(SCB_u32PriorityGroup == SCB_PRIORITY_GROUP_UNKNOWN)
+	{
+		u32 Register_Val = PRIORITY_GROUP_MASK;  				// Initial value with a mask that covers bits [10:8] in case the configuration changes.
+		Register_Val &= SCB->AIRCR; 							// Perform a bitwise AND operation to isolate the relevant bits.
+		SCB_u32PriorityGroup = (Register_Val >> SCB_AIRCR_PRIGROUP_POS); 	// Right-shift to obtain the actual priority grouping field.
+	}
+	return SCB_u32PriorityGroup;
+}
+
+
+
+
+/**
+ *  brief 	 	Relocate Vector Table
+ *  details		Copies the active vector table (flash) into an aligned SRAM block and points
+ *  			SCB->VTOR to it, so handlers can be installed at run time with SCB_SetVector.
+ *  note		Calling it again has no effect.
+ */
+
+void SCB_RelocateVectorTable(void)
+{
+	volatile u32 * Source = (volatile u32 *) SCB->VTOR;	// Table in use (0 = flash aliased at address 0 after reset)
+	u32 Index;
+
+	if(Source == SCB_u32RamVectorTable)
+	{
+		return;
+	}
+
+	/* Same entries in both tables, so an interrupt during the switch is served either way */
+	for(Index = 0; Index < SCB_VECTOR_TABLE_SIZE; Index++)
+	{
+		SCB_u32RamVectorTable[Index] = Source[Index];
+	}
+	CORE_DSB();
+
+	SCB->VTOR = (u32) SCB_u32RamVectorTable;
+	CORE_DSB();
+	CORE_ISB();
+}
+
+
+
+
+
+/**
+ *  brief 	 	Set Vector
+ *  details		Installs a handler directly in the SRAM vector table.
+ *  param [in]	IRQn     Interrupt number (system exceptions included)
+ *  param [in]	Handler  Function to run for this interrupt
+ * 	return		OK     The handler is installed
+ * 	return		ERROR  The table was not relocated, IRQn is out of range or Handler is NULL
+ */
+
+States_Type SCB_SetVector(IRQn_Type IRQn, SCB_Handler_Type Handler)
+{
+	s32 Index = (s32)IRQn + 16;		// Entry 0 is the initial stack pointer, IRQ 0 is entry 16
+
+	if(((volatile u32 *) SCB->VTOR != SCB_u32RamVectorTable) || (Handler == NULL) ||
+	   (Index < 1) || (Index >= (s32)SCB_VECTOR_TABLE_SIZE))
+	{
+		return ERROR;
+	}
+
+	SCB_u32RamVectorTable[Index] = (u32) Handler;
+	CORE_DSB();					// Entry visible before the interrupt can be taken
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Vector
+ *  details		Returns the handler of an interrupt from the active vector table.
+ *  param [in]	IRQn     Interrupt number
+ * 	return		Handler address, NULL when IRQn is out of range
+ */
+
+SCB_Handler_Type SCB_GetVector(IRQn_Type IRQn)
+{
+	s32 Index = (s32)IRQn + 16;
+
+	if((Index < 1) || (Index >= (s32)SCB_VECTOR_TABLE_SIZE))
+	{
+		return NULL;
+	}
+	return (SCB_Handler_Type) ((volatile u32 *) SCB->VTOR)[Index];
+}
+
+
+
+
+
+/**
+ *  brief 	 	Idle Init
+ *  details		Sets SEVONPEND, clears SLEEPDEEP and SLEEPONEXIT and keeps the hooks
+ *  param [in]	TimeSource  Time base of the statistics (must run during sleep), NULL for none
+ *  param [in]	WorkCheck   Checked with interrupts masked right before sleeping, may be NULL
+ */
+
+void SCB_IdleInit(SCB_TimeSource_Type TimeSource, SCB_WorkCheck_Type WorkCheck)
+{
+	u32 Register_Value = SCB->SCR;
+
+	SET_BIT(Register_Value, SCB_SCR_SEVONPEND_POS);
+	CLR_BIT(Register_Value, SCB_SCR_SLEEPDEEP_POS);
+	CLR_BIT(Register_Value, SCB_SCR_SLEEPONEXIT_POS);
+	SCB->SCR = Register_Value;
+
+	SCB_IdleTimeSource = TimeSource;
+	SCB_IdleWorkCheck  = WorkCheck;
+}
+
+
+
+
+/* Wake-up latency of a mode: filtered measurement, the configured estimate before any sample */
+static u32 SCB_u32WakeLatency(u8 Mode)
+{
+	if(SCB_IdleStats[Mode].LatencySamples != 0)
+	{
+		return SCB_IdleStats[Mode].WakeLatency;
+	}
+	return (Mode == SCB_IDLE_WFI) ? SCB_IDLE_WFI_LATENCY : SCB_IDLE_WFE_LATENCY;
+}
+
+
+
+
+/**
+ *  brief 	 	Idle
+ *  details		Picks no sleep, WFE, WFI or sleep-on-exit from the expected idle time and sleeps
+ *  param [in]	ExpectedIdle  Time until the next known wake-up, SCB_IDLE_FOREVER for handlers only
+ * 	return		Mode used
+ */
+
+u8 SCB_Idle(u32 ExpectedIdle)
+{
+	SCB_IdleStats_Type * Stats;
+	u32 Start = 0;
+	u32 Wake;
+	u32 Late;
+	u32 Cap;
+	u8  Mode;
+
+	/* Masked from the work check to the sleep: an interrupt in between still ends WFI / WFE */
+	CORE_DISABLE_IRQ();
+
+	if((SCB_IdleWorkCheck != NULL) && (SCB_IdleWorkCheck() != 0))
+	{
+		Mode = SCB_IDLE_NONE;
+	}
+	else if(ExpectedIdle == SCB_IDLE_FOREVER)
+	{
+		Mode = SCB_IDLE_SLEEP_ON_EXIT;
+	}
+	else if((u64)ExpectedIdle >= ((u64)SCB_IDLE_BREAK_EVEN * SCB_u32WakeLatency(SCB_IDLE_WFI)))
+	{
+		Mode = SCB_IDLE_WFI;
+	}
+	else if((u64)ExpectedIdle >= ((u64)SCB_IDLE_BREAK_EVEN * SCB_u32WakeLatency(SCB_IDLE_WFE)))
+	{
+		Mode = SCB_IDLE_WFE;
+	}
+	else
+	{
+		Mode = SCB_IDLE_NONE;
+	}
+
+	Stats = &SCB_IdleStats[Mode];
+	Stats->Entries++;
+	if(Mode == SCB_IDLE_NONE)
+	{
+		CORE_ENABLE_IRQ();
+		return Mode;
+	}
+
+	if(SCB_IdleTimeSource != NULL)
+	{
+		Start = SCB_IdleTimeSource();
+	}
+
+	if(Mode == SCB_IDLE_SLEEP_ON_EXIT)
+	{
+		/* WFI with PRIMASK still set: a handler calling SCB_ExitSleepOnExit can not run between
+		 * the enable and the WFI. The first interrupt ends the WFI, its handler runs on the enable
+		 * and from then on every return to thread mode sleeps again until SCB_ExitSleepOnExit. */
+		SET_BIT(SCB->SCR, SCB_SCR_SLEEPONEXIT_POS);
+		CORE_DSB();
+		CORE_WFI();
+		CORE_ENABLE_IRQ();
+	}
+	else
+	{
+		CORE_DSB();
+		if(Mode == SCB_IDLE_WFI)
+		{
+			CORE_WFI();
+		}
+		else
+		{
+			/* Every exception return sets the event register: clear it first, else WFE returns
+			 * at once. The clearing WFE may also consume the event of an interrupt that became
+			 * pending after the work check, hence the check before the real WFE. */
+			CORE_SEV();
+			CORE_WFE();
+			if(GET_BIT(SCB->ICSR, SCB_ICSR_ISRPENDING_POS) == 0)
+			{
+				CORE_WFE();
+			}
+		}
+	}
+
+	if(SCB_IdleTimeSource != NULL)
+	{
+		Wake = SCB_IdleTimeSource();
+		Stats->TotalTime += (u32)(Wake - Start);
+
+		/* Woken by the expected event (not earlier): the delay is the wake-up latency */
+		Late = (Wake - Start) - ExpectedIdle;
+		if((Mode != SCB_IDLE_SLEEP_ON_EXIT) && ((Wake - Start) >= ExpectedIdle))
+		{
+			Stats->LastWakeLatency = Late;
+			if(Late > Stats->MaxWakeLatency)
+			{
+				Stats->MaxWakeLatency = Late;
+			}
+			Cap = SCB_IDLE_LATENCY_CAP * ((Mode == SCB_IDLE_WFI) ? SCB_IDLE_WFI_LATENCY : SCB_IDLE_WFE_LATENCY);
+			if(Late > Cap)
+			{
+				Late = Cap;
+			}
+			if(Stats->LatencySamples == 0)
+			{
+				Stats->WakeLatency = Late;
+			}
+			else if(Late >= Stats->WakeLatency)
+			{
+				Stats->WakeLatency += (Late - Stats->WakeLatency) >> SCB_IDLE_LATENCY_SHIFT;
+			}
+			else
+			{
+				Stats->WakeLatency -= (Stats->WakeLatency - Late) >> SCB_IDLE_LATENCY_SHIFT;
+			}
+			Stats->LatencySamples++;
+		}
+	}
+
+	/* The pending handler (if any) runs here */
+	CORE_ENABLE_IRQ();
+	return Mode;
+}
+
+
+
+
+/**
+ *  brief 	 	Exit Sleep On Exit
+ *  details		Called by a handler: the core returns to thread mode instead of sleeping again
+ */
+
+void SCB_ExitSleepOnExit(void)
+{
+	CLR_BIT(SCB->SCR, SCB_SCR_SLEEPONEXIT_POS);
+}
+
+
+
+
+/**
+ *  brief 	 	Set Sleep Deep
+ *  param [in]	Enable  1 deep sleep, 0 sleep
+ */
+
+void SCB_SetSleepDeep(u8 Enable)
+{
+	if(Enable == 1)
+	{
+		SET_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_POS);
+	}
+	else
+	{
+		CLR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_POS);
+	}
+}
+
+
+
+
+/**
+ *  brief 	 	Get Idle Stats
+ *  param [in]	Mode   SCB_IDLE_NONE .. SCB_IDLE_SLEEP_ON_EXIT
+ *  param [out]	Stats  Receives the statistics of the mode
+ * 	return		OK / ERROR
+ */
+
+States_Type SCB_GetIdleStats(u8 Mode, SCB_IdleStats_Type * Stats)
+{
+	if((Mode >= SCB_IDLE_MODES) || (Stats == NULL))
+	{
+		return ERROR;
+	}
+	*Stats = SCB_IdleStats[Mode];
+	return OK;
 }
 
+
+
+
+/**
+ *  brief 	 	Reset Idle Stats
+ *  details		Clears the statistics of every mode
+ */
+
+void SCB_ResetIdleStats(void)
+{
+	u8 Mode;
+
+	for(Mode = 0; Mode < SCB_IDLE_MODES; Mode++)
+	{
+		SCB_IdleStats[Mode].Entries         = 0;
+		SCB_IdleStats[Mode].TotalTime       = 0;
+		SCB_IdleStats[Mode].LastWakeLatency = 0;
+		SCB_IdleStats[Mode].MaxWakeLatency  = 0;
+		SCB_IdleStats[Mode].WakeLatency     = 0;
+		SCB_IdleStats[Mode].LatencySamples  = 0;
+	}
+}
@@ -10,6 +10,7 @@
 
 /***************************************Start Include Section*****************/
 #include "Libraries/STD_TYPES.h"
+#include "NVIC/Cortex_M3_NVIC.h"
 /***************************************End Include Section*****************/
 /******************************Start Data Type Section***********************/
 
@@ -27,12 +28,33 @@ typedef struct {
 	volatile u32 CFSR;                 // Configurable Fault Status Register
 } SCB_Type;
 
+typedef void (*SCB_Handler_Type)(void);		// Exception / interrupt handler
+
+typedef u32 (*SCB_TimeSource_Type)(void);	// Free running time base of the idle statistics
+typedef u8  (*SCB_WorkCheck_Type)(void);	// Returns 1 when thread mode has work to do
+
+/* Time spent in one idle mode, in units of the idle time source */
+typedef struct {
+	u32 Entries;						// Times the mode was used
+	u64 TotalTime;						// Time from entry to wake-up
+	u32 LastWakeLatency;				// Wake-up time - expected wake-up time (last sample)
+	u32 MaxWakeLatency;					// Worst sample
+	u32 WakeLatency;					// Filtered latency used to pick the mode (SCB_IDLE_LATENCY_SHIFT)
+	u32 LatencySamples;					// Wake-ups at or after the expected time
+} SCB_IdleStats_Type;
+
 
 /******************************End Data Type Section***********************/
 
 /********************************************Macro Section Start********************************/
 #define SCB_BASE        (0xE000ED00U)       // SCB base address
+#ifndef CORE_SIMULATION
 #define SCB             ((SCB_Type *) SCB_BASE)
+#else
+/* Host build: the driver works on the register model of Host_Tools/NVIC_Sim */
+extern SCB_Type SCB_SimRegisters;
+#define SCB             (&SCB_SimRegisters)
+#endif
 
 #define SCB_PRIORITYGROUP_0					0X00000007U			/*0 bit for pre-emption priority
 																	and 4 bit for sub priority*/
@@ -51,8 +73,53 @@ typedef struct {
 #define SCB_AIRCR_KEY_PRIGROUP_MASK			0XF8FFUL			/*Clear the VECKTKEY and PRIGROUP Positions*/
 #define PRIORITY_GROUP_MASK					0x700UL				/*// Initial value with a mask that covers bits [10:8]*/
 
+#define SCB_VECTOR_TABLE_SIZE				(16U + 60U)			/*Stack pointer + 15 system exceptions + 60 STM32F103 interrupts*/
+#define SCB_VECTOR_TABLE_ALIGN				512U				/*VTOR needs the table size rounded up to a power of two (304 -> 512 bytes)*/
+
+#define SCB_ICSR_ISRPENDING_POS				22U					/*SCB_ICSR  An interrupt is pending (NMI and faults excluded)*/
+#define SCB_ICSR_PENDSTCLR_POS				25U					/*SCB_ICSR  Clear SysTick pending (write 1)*/
+#define SCB_ICSR_PENDSTSET_POS				26U					/*SCB_ICSR  SysTick pending (read) / set pending (write 1)*/
+#define SCB_ICSR_PENDSVSET_POS				28U					/*SCB_ICSR  Set PendSV pending (write 1)*/
+
+#define SCB_SCR_SLEEPONEXIT_POS				1U					/*SCB_SCR  Sleep again on return to thread mode*/
+#define SCB_SCR_SLEEPDEEP_POS				2U					/*SCB_SCR  Deep sleep (Stop / Standby with PWR)*/
+#define SCB_SCR_SEVONPEND_POS				4U					/*SCB_SCR  A newly pending interrupt is a WFE event*/
+
+#define SCB_IDLE_NONE						0U					/*Work pending or idle too short: no sleep*/
+#define SCB_IDLE_WFE						1U					/*Wait for event*/
+#define SCB_IDLE_WFI						2U					/*Wait for interrupt*/
+#define SCB_IDLE_SLEEP_ON_EXIT				3U					/*Run from handlers only until SCB_ExitSleepOnExit*/
+#define SCB_IDLE_MODES						4U
+
+#define SCB_IDLE_FOREVER					0XFFFFFFFFUL		/*Expected idle time: only handlers have work*/
+
 /********************************************Macro End Section**********************************/
 
+/********************************************Config Section Start********************************/
+
+/* Wake-up latency assumed before a mode was measured, in units of the idle time source */
+#ifndef SCB_IDLE_WFE_LATENCY
+#define SCB_IDLE_WFE_LATENCY				20U
+#endif
+#ifndef SCB_IDLE_WFI_LATENCY
+#define SCB_IDLE_WFI_LATENCY				30U
+#endif
+
+/* Filter of the wake-up latency: each sample moves the estimate by 1 / 2^SHIFT of the difference,
+ * so one late wake-up (e.g. an underestimated ExpectedIdle) does not lock a mode out */
+#ifndef SCB_IDLE_LATENCY_SHIFT
+#define SCB_IDLE_LATENCY_SHIFT				3U
+#endif
+
+/* Samples are capped to this many times the configured latency, so the filtered value (and the
+ * idle time needed to pick the mode again) stays bounded even when a mode is no longer used */
+#define SCB_IDLE_LATENCY_CAP				4U
+
+/* A mode is used when the expected idle time is at least this many times its wake-up latency */
+#define SCB_IDLE_BREAK_EVEN					4U
+
+/********************************************Config Section End**********************************/
+
 /***********************************Software Interface Section Start*****************************/
 
 
@@ -74,11 +141,105 @@ void SCB_SetPriorityGrouping(u32 PriorityGroup);
  *  brief 	 	Get Priority Grouping
  *  details		Get the priority grouping field in the System Control Block (SCB).
  * 	return		Priority grouping field (SCB->AIRCR [10:8] PRIGROUP field).
+ *  note		AIRCR is read once, on the first call (a grouping set by startup code or a bootloader
+ *  			is seen), then the cached value is returned. Change the grouping only through
+ *  			SCB_SetPriorityGrouping, which updates the cache.
  */
 
 u32 SCB_GetPriorityGrouping(void);
 
 
+/**
+ *  brief 	 	Relocate Vector Table
+ *  details		Copies the active vector table (flash) into an aligned SRAM block and points
+ *  			SCB->VTOR to it, so handlers can be installed at run time with SCB_SetVector.
+ *  			Vector fetches then come from SRAM, without flash wait states.
+ *  note		Calling it again has no effect.
+ */
+
+void SCB_RelocateVectorTable(void);
+
+/**
+ *  brief 	 	Set Vector
+ *  details		Installs a handler directly in the SRAM vector table: the core branches to it
+ *  			with no dispatch code in between.
+ *  param [in]	IRQn     Interrupt number (system exceptions NonMaskableInt_IRQn .. SysTick_IRQn included)
+ *  param [in]	Handler  Function to run for this interrupt
+ * 	return		OK     The handler is installed
+ * 	return		ERROR  The table was not relocated, IRQn is out of range or Handler is NULL
+ */
+
+States_Type SCB_SetVector(IRQn_Type IRQn, SCB_Handler_Type Handler);
+
+/**
+ *  brief 	 	Get Vector
+ *  details		Returns the handler of an interrupt from the active vector table.
+ *  param [in]	IRQn     Interrupt number
+ * 	return		Handler address, NULL when IRQn is out of range
+ */
+
+SCB_Handler_Type SCB_GetVector(IRQn_Type IRQn);
+
+/**
+ *  brief 	 	Idle Init
+ *  details		Sets SCR SEVONPEND (a new interrupt ends WFE even while masked) and clears
+ *  			SLEEPDEEP and SLEEPONEXIT
+ *  param [in]	TimeSource  Time base of the statistics and wake-up latency, NULL for none.
+ *  			It must keep counting while the core sleeps (DWT->CYCCNT does not).
+ *  param [in]	WorkCheck   Checked with interrupts masked right before sleeping, may be NULL
+ */
+
+void SCB_IdleInit(SCB_TimeSource_Type TimeSource, SCB_WorkCheck_Type WorkCheck);
+
+/**
+ *  brief 	 	Idle
+ *  details		Picks an idle mode and sleeps:
+ *  			- no sleep when WorkCheck reports work or the idle time is below the break-even
+ *  			  of every mode,
+ *  			- WFI when it exceeds SCB_IDLE_BREAK_EVEN times the WFI wake-up latency, else WFE,
+ *  			- sleep-on-exit for SCB_IDLE_FOREVER: from then on the core only runs handlers,
+ *  			  until one of them calls SCB_ExitSleepOnExit.
+ *  			WFI / WFE run with PRIMASK set, so an interrupt that becomes pending after the work
+ *  			check still ends the sleep; its handler runs before this function returns.
+ *  param [in]	ExpectedIdle  Time until the next known wake-up (e.g. timer deadline), in units of
+ *  			the time source. A wake-up at or after it is a wake-up latency sample.
+ * 	return		SCB_IDLE_NONE, SCB_IDLE_WFE, SCB_IDLE_WFI or SCB_IDLE_SLEEP_ON_EXIT
+ */
+
+u8 SCB_Idle(u32 ExpectedIdle);
+
+/**
+ *  brief 	 	Exit Sleep On Exit
+ *  details		Called by a handler: the core returns to thread mode instead of sleeping again
+ */
+
+void SCB_ExitSleepOnExit(void);
+
+/**
+ *  brief 	 	Set Sleep Deep
+ *  details		Selects deep sleep (SCR SLEEPDEEP) for the next WFI / WFE
+ *  param [in]	Enable  1 deep sleep, 0 sleep
+ */
+
+void SCB_SetSleepDeep(u8 Enable);
+
+/**
+ *  brief 	 	Get Idle Stats
+ *  param [in]	Mode   SCB_IDLE_NONE .. SCB_IDLE_SLEEP_ON_EXIT
+ *  param [out]	Stats  Receives the statistics of the mode
+ * 	return		OK / ERROR (invalid mode)
+ */
+
+States_Type SCB_GetIdleStats(u8 Mode, SCB_IdleStats_Type * Stats);
+
+/**
+ *  brief 	 	Reset Idle Stats
+ *  details		Clears the statistics of every mode (the measured latencies are forgotten)
+ */
+
+void SCB_ResetIdleStats(void);
+
+
 
 
 /***********************************Software Interface End Start*****************************/
@@ -0,0 +1,263 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_STORM.c
+ * @author         : Ahmed Khaled
+ * @brief          : Interrupt Storm Limiter Source File
+ ******************************************************************************/
+
+
+#include "STORM/Cortex_M3_STORM.h"
+#include "Libraries/CORE_INTRINSICS.h"
+
+
+#define STORM_NO_SOURCE			0XFFU
+#define STORM_IRQS_NUM			60U					/*Device interrupts of the STM32F103*/
+
+typedef struct {
+	STORM_Policy_Type Policy;
+	STORM_Stats_Type  Stats;
+	u32 WindowStart;
+	u32 Count;
+	u32 MaskedAt;
+	u32 ReleasedAt;
+	IRQn_Type IRQn;
+	u8  Released;						// Unmasked at least once, ReleasedAt is valid
+} STORM_Source_Type;
+
+static STORM_Source_Type STORM_Sources[STORM_MAX_SOURCES];
+static u8 STORM_u8SourcesNum = 0;
+
+/* Source of each device interrupt, so the handler lookup is a single load */
+static u8 STORM_u8SourceOf[STORM_IRQS_NUM];
+static u8 STORM_u8Initialized = 0;
+
+
+static STORM_Source_Type * STORM_GetSource(IRQn_Type IRQn)
+{
+	if(((s32)IRQn < 0) || ((u32)IRQn >= STORM_IRQS_NUM) || (STORM_u8Initialized == 0) ||
+	   (STORM_u8SourceOf[IRQn] == STORM_NO_SOURCE))
+	{
+		return NULL;
+	}
+	return &STORM_Sources[STORM_u8SourceOf[IRQn]];
+}
+
+
+static void STORM_ClearStats(STORM_Stats_Type * Stats)
+{
+	Stats->Interrupts     = 0;
+	Stats->Storms         = 0;
+	Stats->MaxPerWindow   = 0;
+	Stats->MaskedTime     = 0;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Register
+ *  details		Puts an interrupt under rate limiting
+ *  param [in]	IRQn    Interrupt to watch
+ *  param [in]	Policy  Threshold, window and backoff (copied)
+ * 	return		OK / ERROR
+ */
+
+States_Type STORM_Register(IRQn_Type IRQn, const STORM_Policy_Type * Policy)
+{
+	STORM_Source_Type * Source;
+	u8 Index;
+
+	if(((s32)IRQn < 0) || ((u32)IRQn >= STORM_IRQS_NUM) || (Policy == NULL) ||
+	   (Policy->Threshold == 0) || (Policy->Window == 0))
+	{
+		return ERROR;
+	}
+
+	if(STORM_u8Initialized == 0)
+	{
+		for(Index = 0; Index < STORM_IRQS_NUM; Index++)
+		{
+			STORM_u8SourceOf[Index] = STORM_NO_SOURCE;
+		}
+		STORM_u8Initialized = 1;
+	}
+
+	Source = STORM_GetSource(IRQn);
+	if(Source == NULL)
+	{
+		if(STORM_u8SourcesNum >= STORM_MAX_SOURCES)
+		{
+			return ERROR;
+		}
+		Source = &STORM_Sources[STORM_u8SourcesNum];
+		Source->IRQn = IRQn;
+		STORM_ClearStats(&Source->Stats);
+		Source->Stats.CurrentBackoff = 0;
+		Source->Stats.Masked = 0;
+		Source->WindowStart  = 0;
+		Source->Count        = 0;
+		Source->Released     = 0;
+	}
+
+	Source->Policy = *Policy;
+	if(Source->Policy.MaxBackoff < Source->Policy.Backoff)
+	{
+		Source->Policy.MaxBackoff = Source->Policy.Backoff;
+	}
+
+	/* Publish the source to the handler only once it is complete */
+	CORE_DMB();
+	if(STORM_u8SourceOf[IRQn] == STORM_NO_SOURCE)
+	{
+		STORM_u8SourceOf[IRQn] = STORM_u8SourcesNum;
+		STORM_u8SourcesNum++;
+	}
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	On Interrupt
+ *  details		Counts the interrupt in the current window and masks the source above the threshold.
+ *  			A storm shortly after the previous release doubles the backoff (up to MaxBackoff).
+ *  param [in]	IRQn  Interrupt being handled
+ *  param [in]	Now   Current time
+ * 	return		OK     Interrupt within budget
+ * 	return		ERROR  Storm detected, the source has just been masked
+ */
+
+States_Type STORM_OnInterrupt(IRQn_Type IRQn, u32 Now)
+{
+	STORM_Source_Type * Source = STORM_GetSource(IRQn);
+
+	if(Source == NULL)
+	{
+		return OK;
+	}
+
+	Source->Stats.Interrupts++;
+
+	if((Now - Source->WindowStart) >= Source->Policy.Window)
+	{
+		if(Source->Count > Source->Stats.MaxPerWindow)
+		{
+			Source->Stats.MaxPerWindow = Source->Count;
+		}
+		Source->WindowStart = Now;
+		Source->Count = 0;
+	}
+	Source->Count++;
+
+	if(Source->Count <= Source->Policy.Threshold)
+	{
+		return OK;
+	}
+
+	STORM_DISABLE(IRQn);
+
+	if((Source->Released == 1) && (Source->Stats.CurrentBackoff != 0) &&
+	   ((Now - Source->ReleasedAt) < Source->Policy.Window))
+	{
+		/* The source stormed again right after its release: back off longer */
+		Source->Stats.CurrentBackoff = ((Source->Stats.CurrentBackoff > (Source->Policy.MaxBackoff >> 1)) ?
+										Source->Policy.MaxBackoff : (Source->Stats.CurrentBackoff << 1));
+	}
+	else
+	{
+		Source->Stats.CurrentBackoff = Source->Policy.Backoff;
+	}
+
+	if(Source->Count > Source->Stats.MaxPerWindow)
+	{
+		Source->Stats.MaxPerWindow = Source->Count;
+	}
+	Source->Stats.Storms++;
+	Source->MaskedAt = Now;
+
+	/* STORM_Task must see the whole state once it sees Masked */
+	CORE_DMB();
+	Source->Stats.Masked = 1;
+	return ERROR;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Task
+ *  details		Unmasks the sources whose backoff has expired
+ *  param [in]	Now   Current time
+ */
+
+void STORM_Task(u32 Now)
+{
+	STORM_Source_Type * Source;
+	u8 Index;
+
+	for(Index = 0; Index < STORM_u8SourcesNum; Index++)
+	{
+		Source = &STORM_Sources[Index];
+
+		/* While masked the handler can not run, the source state belongs to this task */
+		if((Source->Stats.Masked == 1) && ((Now - Source->MaskedAt) >= Source->Stats.CurrentBackoff))
+		{
+			Source->Stats.MaskedTime += (Now - Source->MaskedAt);
+			Source->ReleasedAt  = Now;
+			Source->Released    = 1;
+			Source->WindowStart = Now;
+			Source->Count       = 0;
+			Source->Stats.Masked = 0;
+
+			CORE_DMB();
+			STORM_ENABLE(Source->IRQn);
+		}
+	}
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Stats
+ *  details		Copies the storm statistics of a source
+ *  param [in]	IRQn   Watched interrupt
+ *  param [out]	Stats  Receives the statistics
+ * 	return		OK / ERROR
+ */
+
+States_Type STORM_GetStats(IRQn_Type IRQn, STORM_Stats_Type * Stats)
+{
+	STORM_Source_Type * Source = STORM_GetSource(IRQn);
+
+	if((Source == NULL) || (Stats == NULL))
+	{
+		return ERROR;
+	}
+	*Stats = Source->Stats;
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Reset Stats
+ *  details		Clears the statistics of every source, the masked state and backoff are kept
+ */
+
+void STORM_ResetStats(void)
+{
+	u8 Index;
+
+	for(Index = 0; Index < STORM_u8SourcesNum; Index++)
+	{
+		STORM_ClearStats(&STORM_Sources[Index].Stats);
+	}
+}
@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_STORM.h
+ * @author         : Ahmed Khaled
+ * @brief          : Interrupt Storm Limiter Header File
+ ******************************************************************************/
+
+#ifndef CORTEX_M3_STORM_H_
+#define CORTEX_M3_STORM_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+#include "NVIC/Cortex_M3_NVIC.h"
+/***************************************End Include Section*****************/
+
+/********************************************Config Section Start********************************/
+
+#define STORM_MAX_SOURCES					8U					/*Interrupts that can be rate limited*/
+
+/*
+ * How a source is masked and unmasked. A host build can redefine them to drive a
+ * simulated interrupt source instead of the NVIC.
+ */
+#ifndef STORM_DISABLE
+#define STORM_DISABLE(IRQn)					NVIC_DisableIRQ(IRQn)
+#endif
+#ifndef STORM_ENABLE
+#define STORM_ENABLE(IRQn)					NVIC_EnableIRQ(IRQn)
+#endif
+
+/********************************************Config Section End**********************************/
+
+/******************************Start Data Type Section***********************/
+
+/*
+ * All times are in the unit of the Now argument (e.g. a 1 ms tick or DWT cycles),
+ * differences are wrap-around safe.
+ */
+typedef struct {
+	u32 Threshold;						// Interrupts allowed per window
+	u32 Window;							// Length of the counting window
+	u32 Backoff;						// Masked time after a first storm
+	u32 MaxBackoff;						// Limit of the doubling when storms repeat (0 = Backoff)
+} STORM_Policy_Type;
+
+typedef struct {
+	u32 Interrupts;						// Calls of STORM_OnInterrupt
+	u32 Storms;							// Times the source was masked
+	u32 MaxPerWindow;					// Busiest completed window
+	u32 MaskedTime;						// Total time spent masked
+	u32 CurrentBackoff;					// Backoff of the last storm
+	u8  Masked;							// 1 while the source is masked
+} STORM_Stats_Type;
+
+/******************************End Data Type Section***********************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Register
+ *  details		Puts an interrupt under rate limiting
+ *  param [in]	IRQn    Interrupt to watch (device interrupt, IRQn >= 0)
+ *  param [in]	Policy  Threshold, window and backoff (copied)
+ * 	return		OK     Source registered (or its policy updated)
+ * 	return		ERROR  Invalid arguments or no free source
+ */
+
+States_Type STORM_Register(IRQn_Type IRQn, const STORM_Policy_Type * Policy);
+
+/**
+ *  brief 	 	On Interrupt
+ *  details		Called first in the handler of a watched interrupt. Counts the interrupt in the
+ *  			current window and masks the source when the threshold is exceeded.
+ *  param [in]	IRQn  Interrupt being handled
+ *  param [in]	Now   Current time
+ * 	return		OK     Interrupt within budget, handle it
+ * 	return		ERROR  Storm detected, the source has just been masked
+ */
+
+States_Type STORM_OnInterrupt(IRQn_Type IRQn, u32 Now);
+
+/**
+ *  brief 	 	Task
+ *  details		Unmasks the sources whose backoff has expired. Call periodically (e.g. from the
+ *  			tick), at a priority lower than the watched interrupts.
+ *  param [in]	Now   Current time
+ */
+
+void STORM_Task(u32 Now);
+
+/**
+ *  brief 	 	Get Stats
+ *  details		Copies the storm statistics of a source
+ *  param [in]	IRQn   Watched interrupt
+ *  param [out]	Stats  Receives the statistics
+ * 	return		OK     Statistics copied
+ * 	return		ERROR  IRQn is not registered
+ */
+
+States_Type STORM_GetStats(IRQn_Type IRQn, STORM_Stats_Type * Stats);
+
+/**
+ *  brief 	 	Reset Stats
+ *  details		Clears the statistics of every source, the masked state and backoff are kept
+ */
+
+void STORM_ResetStats(void);
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* CORTEX_M3_STORM_H_ */
@@ -0,0 +1,571 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_SysTick.c
+ * @author         : Ahmed Khaled
+ * @brief          : SysTick Timebase Source File
+ ******************************************************************************/
+
+
+#include "SysTick/Cortex_M3_SysTick.h"
+#include "NVIC/Cortex_M3_NVIC.h"
+#include "SCB/Cortex_M3_SCB.h"
+#include "RCC/Cortex_M3_RCC.h"
+#include "DWT/Cortex_M3_DWT.h"
+#include "Libraries/BIT_MATH.h"
+
+
+#define SYSTICK_NO_EXPIRY			0XFFFFFFFFFFFFFFFFULL
+
+
+/*
+ * Time keeping: SysTick_u64Base is the cycle count at the start of the running period and
+ * SysTick_u32Running its length. LOAD always holds the standard tick, a longer (tickless) or
+ * shorter (re-alignment) period is only started by SysTick_Restart.
+ * The readers mask SysTick, so the handler and SysTick_Restart update the pair without a
+ * critical section: a reader of higher priority could see them half updated and is not
+ * supported.
+ */
+static volatile u64 SysTick_u64Base = 0;
+static volatile u32 SysTick_u32Running = 0;
+static u32 SysTick_u32TickCycles = 0;
+static u32 SysTick_u32Hz = 0;
+
+static volatile u64 SysTick_u64Ticks = 0;
+static u64 SysTick_u64NextTick = 0;				// Cycle count of the next tick boundary
+static volatile u8 SysTick_u8Tickless = 0;
+static u64 SysTick_u64LastCycles = 0;			// Last time read, to detect a clock going back
+
+/* Microseconds up to SysTick_u64UsEpoch (cycle count of the last clock change) */
+static u64 SysTick_u64UsBase = 0;
+static u64 SysTick_u64UsEpoch = 0;
+
+static SysTick_Timer_Type * SysTick_Wheel[SYSTICK_WHEEL_SLOTS];
+static void (*SysTick_pvTickHook)(void) = NULL;
+static u8 SysTick_u8ClockRegistered = 0;
+
+
+/* Masks SysTick_Handler (its current priority, which the application may have changed) */
+static u32 SysTick_Lock(void)
+{
+	return NVIC_EnterCritical(NVIC_GetPriority(SysTick_IRQn), SYSTICK_CRITICAL_ID);
+}
+
+
+static u8 SysTick_WrapPending(void)
+{
+	return (u8)GET_BIT(SCB->ICSR, SCB_ICSR_PENDSTSET_POS);
+}
+
+
+/* Cycles since SysTick_u64Base, a wrap not yet handled included (SysTick masked) */
+static u32 SysTick_Elapsed(void)
+{
+	u32 Value = SysTick->VAL;
+
+	if(SysTick_WrapPending())
+	{
+		Value = SysTick->VAL;
+		if(Value == 0)
+		{
+			return SysTick_u32Running - 1UL;				// Reached 0, not reloaded yet
+		}
+		return SysTick_u32Running + (SysTick->LOAD - Value);
+	}
+	return SysTick_u32Running - 1UL - Value;
+}
+
+
+/* Current cycle count for the readers (SysTick masked) */
+static u64 SysTick_Now(void)
+{
+	u64 Cycles = SysTick_u64Base + SysTick_Elapsed();
+
+	SYSTICK_ASSERT(Cycles >= SysTick_u64LastCycles);
+	SysTick_u64LastCycles = Cycles;
+	return Cycles;
+}
+
+
+/*
+ * Current tick (SysTick masked). SysTick_u64Ticks only advances in the handler, which
+ * replays the ticks of a tickless period when it ends: the boundaries already passed
+ * since SysTick_u64NextTick are counted from the time.
+ */
+static u64 SysTick_CurrentTick(void)
+{
+	u64 Now = SysTick_Now();
+
+	if(Now < SysTick_u64NextTick)
+	{
+		return SysTick_u64Ticks;
+	}
+	return SysTick_u64Ticks + 1U + ((Now - SysTick_u64NextTick) / SysTick_u32TickCycles);
+}
+
+
+static u64 SysTick_CyclesToUs(u64 Cycles, u32 Hz)
+{
+	/* Split to keep Cycles * 1000000 inside 64 bits */
+	return ((Cycles / Hz) * 1000000ULL) + (((Cycles % Hz) * 1000000ULL) / Hz);
+}
+
+
+/*
+ * Starts a period ending at the cycle count Target (moved to the next tick boundary when
+ * already passed). The counter is stopped while LOAD / VAL are rewritten, the lost cycles
+ * are accounted with SYSTICK_STOPPED_CYCLES. On the processor clock the counter reloads
+ * as soon as it is enabled, so LOAD can be set back to the standard tick right after.
+ */
+static void SysTick_Restart(u64 Target)
+{
+	u64 Now;
+	u32 Period;
+
+	CLR_BIT(SysTick->CTRL, SYSTICK_CTRL_ENABLE_POS);
+	Now = SysTick_u64Base + SysTick_Elapsed() + SYSTICK_STOPPED_CYCLES;
+
+	while(Target < Now + 2U)
+	{
+		Target += SysTick_u32TickCycles;
+	}
+	Period = (Target - Now > SYSTICK_MAX_PERIOD) ? SYSTICK_MAX_PERIOD : (u32)(Target - Now);
+
+	SysTick->LOAD = Period - 1UL;
+	SysTick->VAL  = 0;													// Reload from LOAD on the next clock
+	SCB->ICSR     = (1UL << SCB_ICSR_PENDSTCLR_POS);					// A pending wrap is in Now already
+	SET_BIT(SysTick->CTRL, SYSTICK_CTRL_ENABLE_POS);
+	SysTick->LOAD = SysTick_u32TickCycles - 1UL;
+
+	SysTick_u64Base    = Now;
+	SysTick_u32Running = Period;
+}
+
+
+/* Back to the periodic tick at the next tick boundary (SysTick masked) */
+static void SysTick_ResumeTick(void)
+{
+	/* A pending wrap ends the tickless period: the handler resumes the tick */
+	if((SysTick_u8Tickless == 0) || SysTick_WrapPending())
+	{
+		return;
+	}
+	SysTick_Restart(SysTick_u64NextTick);
+	SysTick_u8Tickless = 0;
+}
+
+
+static void SysTick_WheelInsert(SysTick_Timer_Type * Timer)
+{
+	u32 Slot = (u32)(Timer->Expiry & (SYSTICK_WHEEL_SLOTS - 1U));
+
+	Timer->Next = SysTick_Wheel[Slot];
+	SysTick_Wheel[Slot] = Timer;
+	Timer->Active = 1;
+}
+
+
+static void SysTick_WheelRemove(SysTick_Timer_Type * Timer)
+{
+	SysTick_Timer_Type ** Link = &SysTick_Wheel[Timer->Expiry & (SYSTICK_WHEEL_SLOTS - 1U)];
+
+	while(*Link != NULL)
+	{
+		if(*Link == Timer)
+		{
+			*Link = Timer->Next;
+			break;
+		}
+		Link = &(*Link)->Next;
+	}
+	Timer->Next   = NULL;
+	Timer->Active = 0;
+}
+
+
+/*
+ * Runs the timers of a tick. The slot is searched again after each callback since a
+ * callback may start or stop timers; a timer is never re-armed in the running tick.
+ */
+static void SysTick_RunWheel(u64 Tick)
+{
+	SysTick_Timer_Type * Timer;
+
+	for(;;)
+	{
+		Timer = SysTick_Wheel[Tick & (SYSTICK_WHEEL_SLOTS - 1U)];
+		while((Timer != NULL) && (Timer->Expiry > Tick))
+		{
+			Timer = Timer->Next;								// Expires in a later round of the wheel
+		}
+		if(Timer == NULL)
+		{
+			break;
+		}
+
+		SysTick_WheelRemove(Timer);
+		if(Timer->Period != 0)
+		{
+			Timer->Expiry += Timer->Period;
+			SysTick_WheelInsert(Timer);
+		}
+		Timer->Callback(Timer->Arg);
+	}
+}
+
+
+static u64 SysTick_NextExpiry(void)
+{
+	u64 Next = SYSTICK_NO_EXPIRY;
+	SysTick_Timer_Type * Timer;
+	u32 Slot;
+
+	for(Slot = 0; Slot < SYSTICK_WHEEL_SLOTS; Slot++)
+	{
+		for(Timer = SysTick_Wheel[Slot]; Timer != NULL; Timer = Timer->Next)
+		{
+			if(Timer->Expiry < Next)
+			{
+				Next = Timer->Expiry;
+			}
+		}
+	}
+	return Next;
+}
+
+
+/* RCC clock callback: folds the time at the old frequency and restarts on the new one.
+ * RCC calls it from thread mode only (the CSS NMI defers the callbacks to RCC_voidCSSTask). */
+static void SysTick_ClockChanged(void)
+{
+	u32 State = SysTick_Lock();
+	u64 Now = SysTick_u64Base + SysTick_Elapsed();
+
+	SysTick_u64UsBase += SysTick_CyclesToUs(Now - SysTick_u64UsEpoch, SysTick_u32Hz);
+	SysTick_u64UsEpoch = Now;
+
+	SysTick_u32Hz         = RCC_u32GetBusClockHz(AHB_BUS);
+	SysTick_u32TickCycles = SysTick_u32Hz / SYSTICK_TICK_HZ;
+
+	SysTick_Restart(Now + SysTick_u32TickCycles);
+	SysTick_u64NextTick = SysTick_u64Base + SysTick_u32Running;
+	SysTick_u8Tickless  = 0;
+
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Init
+ *  details		Starts SysTick on HCLK at SYSTICK_TICK_HZ and registers with RCC so the period
+ *  			follows every clock tree change. Clears the time and the timer wheel.
+ */
+
+void SysTick_Init(void)
+{
+	u32 Slot;
+
+	SysTick->CTRL = 0;
+	SCB->ICSR = (1UL << SCB_ICSR_PENDSTCLR_POS);
+
+	for(Slot = 0; Slot < SYSTICK_WHEEL_SLOTS; Slot++)
+	{
+		SysTick_Wheel[Slot] = NULL;
+	}
+
+	SysTick_u32Hz         = RCC_u32GetBusClockHz(AHB_BUS);
+	SysTick_u32TickCycles = SysTick_u32Hz / SYSTICK_TICK_HZ;
+
+	SysTick_u64Base     = 0;
+	SysTick_u32Running  = SysTick_u32TickCycles;
+	SysTick_u64NextTick = SysTick_u32TickCycles;
+	SysTick_u64Ticks    = 0;
+	SysTick_u8Tickless  = 0;
+	SysTick_u64UsBase   = 0;
+	SysTick_u64UsEpoch  = 0;
+	SysTick_u64LastCycles = 0;
+
+	if(SysTick_u8ClockRegistered == 0)
+	{
+		if(RCC_enuRegisterClockCallback(SysTick_ClockChanged) == OK)
+		{
+			SysTick_u8ClockRegistered = 1;
+		}
+	}
+
+	NVIC_SetPriority(SysTick_IRQn, SYSTICK_PRIORITY);
+
+	SysTick->LOAD = SysTick_u32TickCycles - 1UL;
+	SysTick->VAL  = 0;
+	SysTick->CTRL = (1UL << SYSTICK_CTRL_CLKSOURCE_POS) | (1UL << SYSTICK_CTRL_TICKINT_POS) |
+					(1UL << SYSTICK_CTRL_ENABLE_POS);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Cycles
+ * 	return		HCLK cycles since SysTick_Init
+ */
+
+u64 SysTick_GetCycles(void)
+{
+	u32 State = SysTick_Lock();
+	u64 Cycles = SysTick_Now();
+
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+	return Cycles;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Microseconds
+ * 	return		Microseconds since SysTick_Init
+ */
+
+u64 SysTick_GetMicros(void)
+{
+	u32 State = SysTick_Lock();
+	u64 Cycles = SysTick_Now();
+	u64 Micros = SysTick_u64UsBase + SysTick_CyclesToUs(Cycles - SysTick_u64UsEpoch, SysTick_u32Hz);
+
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+	return Micros;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Get Ticks
+ * 	return		Ticks since SysTick_Init
+ */
+
+u64 SysTick_GetTicks(void)
+{
+	u32 State = SysTick_Lock();
+	u64 Ticks = SysTick_CurrentTick();
+
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+	return Ticks;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Delay Microseconds
+ *  param [in]	Us  Time to wait
+ */
+
+void SysTick_DelayUs(u32 Us)
+{
+	u64 Cycles = ((u64)Us * RCC_u32GetBusClockHz(AHB_BUS)) / 1000000ULL;
+	u32 Chunk;
+	u32 Start;
+
+	DWT_EnableCycleCounter();
+
+	/* In chunks below 2^31 cycles, the 32-bit counter wraps in about a minute at 72 MHz */
+	while(Cycles != 0)
+	{
+		Chunk = (Cycles > 0X7FFFFFFFULL) ? 0X7FFFFFFFUL : (u32)Cycles;
+		Start = DWT_GET_CYCLES();
+		while((u32)(DWT_GET_CYCLES() - Start) < Chunk)
+		{
+			/*Wait*/
+		}
+		Cycles -= Chunk;
+	}
+}
+
+
+
+
+
+/**
+ *  brief 	 	Set Tick Hook
+ *  param [in]	Hook  Function called on each tick, NULL to remove
+ */
+
+void SysTick_SetTickHook(void (*Hook)(void))
+{
+	u32 State = SysTick_Lock();
+
+	SysTick_pvTickHook = Hook;
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Timer Start
+ * 	return		OK / ERROR
+ */
+
+States_Type SysTick_TimerStart(SysTick_Timer_Type * Timer, u32 Delay, u32 Period,
+							   SysTick_Callback_Type Callback, void * Arg)
+{
+	u32 State;
+
+	if((Timer == NULL) || (Callback == NULL))
+	{
+		return ERROR;
+	}
+
+	State = SysTick_Lock();
+	if(Timer->Active == 1)
+	{
+		SysTick_WheelRemove(Timer);
+	}
+	Timer->Expiry   = SysTick_CurrentTick() + ((Delay == 0) ? 1UL : Delay);
+	Timer->Period   = Period;
+	Timer->Callback = Callback;
+	Timer->Arg      = Arg;
+	SysTick_WheelInsert(Timer);
+
+	/* The programmed wake-up may be later than the new deadline */
+	SysTick_ResumeTick();
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+
+	return OK;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Timer Stop
+ *  param [in]	Timer  Timer
+ */
+
+void SysTick_TimerStop(SysTick_Timer_Type * Timer)
+{
+	u32 State;
+
+	if(Timer == NULL)
+	{
+		return;
+	}
+
+	State = SysTick_Lock();
+	if(Timer->Active == 1)
+	{
+		SysTick_WheelRemove(Timer);
+	}
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Enter Tickless
+ *  details		Programs one SysTick period ending on the tick boundary of the next deadline,
+ *  			limited by the 24-bit counter (about 233 ms at 72 MHz)
+ *  param [in]	MaxTicks  Longest sleep wanted by the caller
+ * 	return		Ticks until the programmed wake-up, 0 when the periodic tick is kept
+ */
+
+u32 SysTick_EnterTickless(u32 MaxTicks)
+{
+	u32 State = SysTick_Lock();
+	u32 Sleep = MaxTicks;
+	u32 HardwareTicks;
+	u64 Next;
+
+	if((SysTick_u8Tickless == 1) || SysTick_WrapPending())
+	{
+		NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+		return 0;
+	}
+
+	/* Expired timers already ran, so Next is after the current tick */
+	Next = SysTick_NextExpiry();
+	if((Next != SYSTICK_NO_EXPIRY) && ((Next - SysTick_u64Ticks) < Sleep))
+	{
+		Sleep = (u32)(Next - SysTick_u64Ticks);
+	}
+
+	/* Tick boundaries reachable in one period: the next one is less than a tick away */
+	HardwareTicks = ((SYSTICK_MAX_PERIOD - (u32)(SysTick_u64NextTick - (SysTick_u64Base + SysTick_Elapsed())))
+					/ SysTick_u32TickCycles) + 1UL;
+	if(Sleep > HardwareTicks)
+	{
+		Sleep = HardwareTicks;
+	}
+
+	if(Sleep < SYSTICK_MIN_TICKLESS_TICKS)
+	{
+		NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+		return 0;
+	}
+
+	SysTick_Restart(SysTick_u64NextTick + ((u64)(Sleep - 1UL) * SysTick_u32TickCycles));
+	SysTick_u8Tickless = 1;
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+
+	return Sleep;
+}
+
+
+
+
+
+/**
+ *  brief 	 	Exit Tickless
+ *  details		Back to the periodic tick after an early wake-up
+ */
+
+void SysTick_ExitTickless(void)
+{
+	u32 State = SysTick_Lock();
+
+	SysTick_ResumeTick();
+	NVIC_ExitCritical(State, SYSTICK_CRITICAL_ID);
+}
+
+
+
+
+
+/**
+ *  brief 	 	Handler
+ *  details		Accounts the period that ended, then runs every tick boundary it reached: the
+ *  			timers of the tick and the tick hook. The half tick margin absorbs the error of
+ *  			SYSTICK_STOPPED_CYCLES.
+ */
+
+void SysTick_Handler(void)
+{
+	u64 Now;
+
+	SysTick_u64Base   += SysTick_u32Running;
+	SysTick_u32Running = SysTick_u32TickCycles;
+	SysTick_u8Tickless = 0;
+
+	Now = SysTick_u64Base + (SysTick_u32TickCycles / 2U);
+	while(SysTick_u64NextTick <= Now)
+	{
+		SysTick_u64NextTick += SysTick_u32TickCycles;
+		SysTick_u64Ticks++;
+		SysTick_RunWheel(SysTick_u64Ticks);
+		if(SysTick_pvTickHook != NULL)
+		{
+			SysTick_pvTickHook();
+		}
+	}
+}
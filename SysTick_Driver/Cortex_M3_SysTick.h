@@ -0,0 +1,200 @@
+/**
+ ******************************************************************************
+ * @file           : Cortex_M3_SysTick.h
+ * @author         : Ahmed Khaled
+ * @brief          : SysTick Timebase Header File
+ ******************************************************************************/
+
+#ifndef CORTEX_M3_SYSTICK_H_
+#define CORTEX_M3_SYSTICK_H_
+
+/***************************************Start Include Section*****************/
+#include "Libraries/STD_TYPES.h"
+/***************************************End Include Section*****************/
+
+/********************************************Config Section Start********************************/
+
+#ifndef SYSTICK_TICK_HZ
+#define SYSTICK_TICK_HZ						1000U				/*Tick rate of the timer wheel (HCLK / SYSTICK_TICK_HZ must fit 24 bits)*/
+#endif
+
+/* NVIC_SetPriority value set by SysTick_Init (1 .. 15: the driver masks SysTick with BASEPRI) */
+#ifndef SYSTICK_PRIORITY
+#define SYSTICK_PRIORITY					15U
+#endif
+
+#define SYSTICK_WHEEL_SLOTS					16U					/*Timer wheel slots, must be a power of two*/
+
+/* Cycles lost while the counter is stopped to be reprogrammed (tickless entry / exit), tune with DWT */
+#ifndef SYSTICK_STOPPED_CYCLES
+#define SYSTICK_STOPPED_CYCLES				4U
+#endif
+
+/* Shorter idle periods keep the periodic tick */
+#ifndef SYSTICK_MIN_TICKLESS_TICKS
+#define SYSTICK_MIN_TICKLESS_TICKS			2U
+#endif
+
+#define SYSTICK_CRITICAL_ID					1U					/*NVIC_EnterCritical section ID of the driver*/
+
+/* Checked on every time read: fails when the time went backwards, i.e. SysTick_Handler was blocked
+ * (PRIMASK, or an interrupt of equal or higher priority running) for more than one period */
+#ifndef SYSTICK_ASSERT
+#define SYSTICK_ASSERT(Condition)			((void)0)
+#endif
+
+/********************************************Config Section End**********************************/
+
+/******************************Start Data Type Section***********************/
+
+typedef struct {
+	volatile u32 CTRL;                 // Control and Status Register
+	volatile u32 LOAD;                 // Reload Value Register
+	volatile u32 VAL;                  // Current Value Register
+	volatile u32 CALIB;                // Calibration Value Register
+} SysTick_Type;
+
+typedef void (*SysTick_Callback_Type)(void * Arg);
+
+/* Software timer, allocated by the application */
+typedef struct SysTick_Timer {
+	struct SysTick_Timer * Next;		// Next timer of the same wheel slot
+	u64 Expiry;							// Tick at which the callback runs
+	u32 Period;							// Reload in ticks, 0 for a one-shot timer
+	SysTick_Callback_Type Callback;		// Called from SysTick_Handler
+	void * Arg;							// Argument passed to Callback
+	u8  Active;
+} SysTick_Timer_Type;
+
+/******************************End Data Type Section***********************/
+
+/********************************************Macro Section Start********************************/
+
+#define SysTick_BASE						(0xE000E010UL)		// SysTick base address
+#define SysTick								((SysTick_Type *) SysTick_BASE)
+
+#define SYSTICK_CTRL_ENABLE_POS				0U					/*SysTick_CTRL  Counter enable*/
+#define SYSTICK_CTRL_TICKINT_POS			1U					/*SysTick_CTRL  Interrupt on reaching 0*/
+#define SYSTICK_CTRL_CLKSOURCE_POS			2U					/*SysTick_CTRL  1: processor clock (HCLK), 0: HCLK / 8*/
+#define SYSTICK_CTRL_COUNTFLAG_POS			16U					/*SysTick_CTRL  Reached 0 since last read*/
+
+#define SYSTICK_MAX_PERIOD					0X01000000UL		/*24-bit counter: longest period in cycles*/
+
+#define SYSTICK_TICKLESS_FOREVER			0XFFFFFFFFUL		/*SysTick_EnterTickless: no limit besides the timers*/
+
+/********************************************Macro End Section**********************************/
+
+/***********************************Software Interface Section Start*****************************/
+
+
+/**
+ *  brief 	 	Init
+ *  details		Starts SysTick on HCLK at SYSTICK_TICK_HZ and registers with RCC so the period
+ *  			follows every clock tree change. Clears the time and the timer wheel.
+ */
+
+void SysTick_Init(void);
+
+/**
+ *  brief 	 	Get Cycles
+ *  details		64-bit monotonic count of HCLK cycles since SysTick_Init (never wraps in practice).
+ *  			After a clock change the count continues at the new frequency.
+ *  note		Only one wrap is counted while SysTick_Handler can not run: when it is blocked for
+ *  			more than one period (PRIMASK, or a long interrupt of equal or higher priority)
+ *  			the time goes back by a period per further wrap (SYSTICK_ASSERT).
+ *  note		Must not be called from an interrupt more urgent than SysTick: SysTick_Handler
+ *  			updates the time base without masking it, such a caller may read it half updated.
+ * 	return		Cycles
+ */
+
+u64 SysTick_GetCycles(void);
+
+/**
+ *  brief 	 	Get Microseconds
+ *  details		64-bit monotonic time since SysTick_Init, correct across clock changes
+ *  note		Same caller restriction as SysTick_GetCycles (not above SysTick priority).
+ * 	return		Microseconds
+ */
+
+u64 SysTick_GetMicros(void);
+
+/**
+ *  brief 	 	Get Ticks
+ *  note		Same caller restriction as SysTick_GetCycles (not above SysTick priority).
+ * 	return		Ticks since SysTick_Init (ticks skipped in tickless mode included)
+ */
+
+u64 SysTick_GetTicks(void);
+
+/**
+ *  brief 	 	Delay Microseconds
+ *  details		Busy waits on the DWT cycle counter at the current HCLK (replaces calibrated loops).
+ *  			Does not depend on SysTick_Handler, so it also works with interrupts masked or
+ *  			inside an interrupt handler.
+ *  param [in]	Us  Time to wait
+ */
+
+void SysTick_DelayUs(u32 Us);
+
+/**
+ *  brief 	 	Set Tick Hook
+ *  details		Function called by SysTick_Handler on each tick, after the timers of the tick.
+ *  			Ticks skipped in tickless mode are replayed one call per tick on wake-up.
+ *  param [in]	Hook  Function, NULL to remove
+ */
+
+void SysTick_SetTickHook(void (*Hook)(void));
+
+/**
+ *  brief 	 	Timer Start
+ *  details		(Re)starts a software timer. Callbacks run in SysTick_Handler. Timers are started
+ *  			and stopped from thread mode or interrupts not more urgent than SysTick.
+ *  param [in]	Timer     Timer (restarted if already active)
+ *  param [in]	Delay     Ticks to the first expiry (0 is handled as 1)
+ *  param [in]	Period    Reload in ticks, 0 for a one-shot timer
+ *  param [in]	Callback  Function to call
+ *  param [in]	Arg       Argument passed to Callback
+ * 	return		OK / ERROR (NULL timer or callback)
+ */
+
+States_Type SysTick_TimerStart(SysTick_Timer_Type * Timer, u32 Delay, u32 Period,
+							   SysTick_Callback_Type Callback, void * Arg);
+
+/**
+ *  brief 	 	Timer Stop
+ *  param [in]	Timer  Timer (no effect when not active)
+ */
+
+void SysTick_TimerStop(SysTick_Timer_Type * Timer);
+
+/**
+ *  brief 	 	Enter Tickless
+ *  details		Reprograms SysTick to interrupt only at the next timer deadline (or MaxTicks), so
+ *  			the core can sleep without being woken by the periodic tick. Call it right before
+ *  			WFI and SysTick_ExitTickless right after.
+ *  param [in]	MaxTicks  Longest sleep wanted by the caller (SYSTICK_TICKLESS_FOREVER for none)
+ * 	return		Ticks until the programmed wake-up, 0 when the periodic tick is kept
+ */
+
+u32 SysTick_EnterTickless(u32 MaxTicks);
+
+/**
+ *  brief 	 	Exit Tickless
+ *  details		After an early wake-up, brings SysTick back to the periodic tick at the next tick
+ *  			boundary; the skipped ticks are replayed by SysTick_Handler. No effect otherwise.
+ */
+
+void SysTick_ExitTickless(void);
+
+/**
+ *  brief 	 	Handler
+ *  details		SysTick exception handler defined by the driver
+ */
+
+void SysTick_Handler(void);
+
+
+/***********************************Software Interface End Start*****************************/
+
+
+#endif /* CORTEX_M3_SYSTICK_H_ */